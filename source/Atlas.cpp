@@ -0,0 +1,278 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Atlas.hpp"
+#include <Langulus/Image.hpp>
+#include <algorithm>
+#include <limits>
+
+
+/// Check if an image is small enough to be packed                            
+///   @param width - image width in pixels                                    
+///   @param height - image height in pixels                                  
+///   @return true if the image can go in an atlas                            
+bool Atlas::Accepts(Count width, Count height) const noexcept {
+   return width and height
+      and width  <= mMaxImageSize and height <= mMaxImageSize
+      and width  + mPadding * 2 <= mPageSize
+      and height + mPadding * 2 <= mPageSize;
+}
+
+/// Get the number of pages in use                                            
+///   @return the number of pages                                             
+auto Atlas::GetPageCount() const noexcept -> Count {
+   return mPages.size();
+}
+
+/// Get the number of mip levels, that the padding keeps apart - each next    
+/// level halves the padding, and neighbors bleed into each other once it's   
+/// less than a pixel                                                         
+///   @return the number of mip levels pages can be sampled at                
+auto Atlas::GetMipCount() const noexcept -> Count {
+   Count count = 1;
+   for (auto padding = mPadding; padding > 1; padding /= 2)
+      ++count;
+   return count;
+}
+
+/// Get the images packed in a page, for composing the page texture           
+///   @param page - the page index                                            
+///   @return the images                                                      
+auto Atlas::GetImages(Offset page) const -> const TMany<Ref<A::Image>>& {
+   return mPages.at(page).mImages;
+}
+
+/// Get the regions of the images packed in a page                            
+///   @param page - the page index                                            
+///   @return the regions, in the same order as the images                    
+auto Atlas::GetRegions(Offset page) const -> const ::std::vector<Region>& {
+   return mPages.at(page).mRegions;
+}
+
+/// Release all pages, along with the images packed in them                   
+void Atlas::Reset() {
+   mPages.clear();
+}
+
+/// Pack an image in the first page that has room for it, or in a new page    
+/// Packing the same image again returns the region it already occupies,      
+/// and counts one more user of it                                            
+///   @param image - the image to pack                                        
+///   @param width - image width in pixels                                    
+///   @param height - image height in pixels                                  
+///   @return the region the image occupies                                   
+auto Atlas::Pack(A::Image* image, Count width, Count height) -> const Region& {
+   for (auto& page : mPages) {
+      for (Offset i = 0; i < page.mImages.GetCount(); ++i) {
+         if (page.mImages[i] == image) {
+            ++page.mUsers[i];
+            return page.mRegions[i];
+         }
+      }
+   }
+
+   const auto region = Reserve(width, height);
+   auto& page = mPages[region.mPage];
+   page.mImages << Ref<A::Image> {image};
+   page.mRegions.push_back(region);
+   page.mUsers.push_back(1);
+   return page.mRegions.back();
+}
+
+/// Stop using a packed image - after its last user releases it, the image    
+/// is dropped, and its room can be reused                                    
+///   @param image - the image to release                                     
+void Atlas::Release(A::Image* image) {
+   for (auto& page : mPages) {
+      for (Offset i = 0; i < page.mImages.GetCount(); ++i) {
+         if (page.mImages[i] != image)
+            continue;
+         if (--page.mUsers[i])
+            return;
+
+         const auto region = page.mRegions[i];
+         page.mImages.RemoveIndex(i);
+         page.mRegions.erase(page.mRegions.begin() + i);
+         page.mUsers.erase(page.mUsers.begin() + i);
+         Free(region);
+         return;
+      }
+   }
+}
+
+/// Return a reserved region's room to its page. The page starts over with    
+/// a flat skyline, once all of its regions are freed                         
+///   @param region - the region to free                                      
+void Atlas::Free(const Region& region) {
+   auto& page = mPages.at(region.mPage);
+   LANGULUS_ASSERT(page.mReserved, Material, "Atlas page has no regions to free");
+   if (--page.mReserved) {
+      page.mFree.push_back(region);
+      return;
+   }
+
+   page.mFree.clear();
+   page.mSkyline.assign(1, Segment {0, 0, mPageSize});
+}
+
+/// Reserve room for an image in the first page that has room for it, or in   
+/// a new page, without recording any image there                             
+///   @param width - image width in pixels                                    
+///   @param height - image height in pixels                                  
+///   @return the reserved region                                             
+auto Atlas::Reserve(Count width, Count height) -> Region {
+   LANGULUS_ASSERT(Accepts(width, height), Material,
+      "Image doesn't fit in an atlas page", width, 'x', height);
+
+   Region region;
+   if (Reuse(width, height, region))
+      return region;
+
+   const auto paddedWidth  = width  + mPadding * 2;
+   const auto paddedHeight = height + mPadding * 2;
+   Offset x, y;
+   auto page = ::std::find_if(mPages.begin(), mPages.end(), [&](Page& p) {
+      return Place(p, paddedWidth, paddedHeight, x, y);
+   });
+
+   if (page == mPages.end()) {
+      // Start a new page with a flat skyline                           
+      mPages.emplace_back();
+      page = mPages.end() - 1;
+      page->mSkyline.push_back({0, 0, mPageSize});
+      LANGULUS_ASSERT(Place(*page, paddedWidth, paddedHeight, x, y),
+         Material, "Image doesn't fit in an empty atlas page");
+   }
+
+   const auto size = static_cast<Real>(mPageSize);
+   ++page->mReserved;
+   region.mPage = static_cast<Offset>(page - mPages.begin());
+   region.mX = x + mPadding;
+   region.mY = y + mPadding;
+   region.mWidth = width;
+   region.mHeight = height;
+   region.mScale = Vec2 {width / size, height / size};
+   region.mOffset = Vec2 {region.mX / size, region.mY / size};
+   return region;
+}
+
+/// Reserve the smallest freed region, that an image fits in. Any room the    
+/// image leaves in that region is lost, until the whole page is freed        
+///   @param width - image width in pixels                                    
+///   @param height - image height in pixels                                  
+///   @param region - [out] the reserved region                               
+///   @return true if a freed region was reused                               
+bool Atlas::Reuse(Count width, Count height, Region& region) {
+   Page* bestPage {};
+   Offset best {};
+   for (auto& page : mPages) {
+      for (Offset i = 0; i < page.mFree.size(); ++i) {
+         const auto& free = page.mFree[i];
+         if (free.mWidth < width or free.mHeight < height)
+            continue;
+         if (bestPage and free.mWidth * free.mHeight >=
+             bestPage->mFree[best].mWidth * bestPage->mFree[best].mHeight)
+            continue;
+         bestPage = &page;
+         best = i;
+      }
+   }
+
+   if (not bestPage)
+      return false;
+
+   region = bestPage->mFree[best];
+   bestPage->mFree.erase(bestPage->mFree.begin() + best);
+   ++bestPage->mReserved;
+
+   const auto size = static_cast<Real>(mPageSize);
+   region.mWidth = width;
+   region.mHeight = height;
+   region.mScale = Vec2 {width / size, height / size};
+   return true;
+}
+
+/// Check if a rectangle fits with its left edge at a skyline segment         
+///   @param page - the page to check                                         
+///   @param segment - the index of the skyline segment                       
+///   @param width - rectangle width                                          
+///   @param height - rectangle height                                        
+///   @param y - [out] the lowest height the rectangle can rest at            
+///   @return true if the rectangle fits inside the page                      
+bool Atlas::Fit(
+   const Page& page, Offset segment, Count width, Count height, Offset& y
+) const noexcept {
+   const auto& skyline = page.mSkyline;
+   if (skyline[segment].mX + width > mPageSize)
+      return false;
+
+   // The rectangle rests on the highest segment below it               
+   y = 0;
+   for (Count covered = 0; covered < width; ++segment) {
+      y = ::std::max(y, skyline[segment].mY);
+      if (y + height > mPageSize)
+         return false;
+      covered += skyline[segment].mWidth;
+   }
+   return true;
+}
+
+/// Place a rectangle at the lowest, then leftmost position in a page, and    
+/// raise the skyline under it                                                
+///   @param page - the page to place in                                      
+///   @param width - rectangle width                                          
+///   @param height - rectangle height                                        
+///   @param x - [out] left edge of the placed rectangle                      
+///   @param y - [out] bottom edge of the placed rectangle                    
+///   @return true if the rectangle was placed                                
+bool Atlas::Place(Page& page, Count width, Count height, Offset& x, Offset& y) const {
+   auto& skyline = page.mSkyline;
+   Offset best = skyline.size();
+   Offset bestY = ::std::numeric_limits<Offset>::max();
+   for (Offset i = 0; i < skyline.size(); ++i) {
+      Offset fitY;
+      if (Fit(page, i, width, height, fitY) and fitY < bestY) {
+         best = i;
+         bestY = fitY;
+      }
+   }
+
+   if (best == skyline.size())
+      return false;
+
+   x = skyline[best].mX;
+   y = bestY;
+   skyline.insert(skyline.begin() + best, Segment {x, y + height, width});
+
+   // Cut the segments, that are now covered by the new one             
+   for (auto i = best + 1; i < skyline.size();) {
+      const auto& previous = skyline[i - 1];
+      const auto edge = previous.mX + previous.mWidth;
+      auto& current = skyline[i];
+      if (current.mX >= edge)
+         break;
+
+      const auto overlap = edge - current.mX;
+      if (current.mWidth > overlap) {
+         current.mX += overlap;
+         current.mWidth -= overlap;
+         break;
+      }
+
+      skyline.erase(skyline.begin() + i);
+   }
+
+   // Merge neighboring segments of the same height                     
+   for (Offset i = 0; i + 1 < skyline.size();) {
+      if (skyline[i].mY == skyline[i + 1].mY) {
+         skyline[i].mWidth += skyline[i + 1].mWidth;
+         skyline.erase(skyline.begin() + i + 1);
+      }
+      else ++i;
+   }
+   return true;
+}
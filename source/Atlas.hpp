@@ -0,0 +1,84 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+#include <vector>
+
+
+///                                                                           
+///   Texture atlas                                                           
+///                                                                           
+/// Packs small images from all materials into shared square pages, so that   
+/// they occupy a single sampler binding per page, instead of one each.       
+/// Uses a bottom-left skyline packer. Each image is surrounded by padding,   
+/// so that filtering and mipmapping don't bleed between neighbors - but      
+/// only down to the mip level, where the padding shrinks to a single pixel,  
+/// so pages must not be sampled past GetMipCount levels.                     
+/// Images are counted by the textures, that use them, and the room of an     
+/// image is reused after its last user releases it. A page, that has no      
+/// images left, starts over empty                                            
+///                                                                           
+struct Atlas {
+   // A packed image's place inside a page                              
+   struct Region {
+      // The page, that contains the image                              
+      Offset mPage {};
+      // Pixel rectangle of the image inside the page, without padding  
+      Offset mX {};
+      Offset mY {};
+      Count mWidth {};
+      Count mHeight {};
+      // Transformation from image UVs to page UVs                      
+      Vec2 mScale {};
+      Vec2 mOffset {};
+   };
+
+   // Width and height of a page in pixels                              
+   Count mPageSize {2048};
+   // Empty pixels around each image                                    
+   Count mPadding {4};
+   // Images larger than this in either dimension aren't packed         
+   Count mMaxImageSize {256};
+
+   bool Accepts(Count width, Count height) const noexcept;
+   auto Pack(A::Image*, Count width, Count height) -> const Region&;
+   void Release(A::Image*);
+   auto Reserve(Count width, Count height) -> Region;
+   void Free(const Region&);
+   void Reset();
+   auto GetPageCount() const noexcept -> Count;
+   auto GetMipCount() const noexcept -> Count;
+   auto GetImages(Offset page) const -> const TMany<Ref<A::Image>>&;
+   auto GetRegions(Offset page) const -> const ::std::vector<Region>&;
+
+private:
+   // A horizontal span of the skyline, at some height                  
+   struct Segment {
+      Offset mX;
+      Offset mY;
+      Count mWidth;
+   };
+
+   struct Page {
+      ::std::vector<Segment> mSkyline;
+      TMany<Ref<A::Image>> mImages;
+      ::std::vector<Region> mRegions;
+      // Number of textures, that use each image                        
+      ::std::vector<Count> mUsers;
+      // Regions, that were freed, and can be reused                    
+      ::std::vector<Region> mFree;
+      // Number of regions, that are reserved and not freed             
+      Count mReserved {};
+   };
+
+   ::std::vector<Page> mPages;
+
+   bool Reuse(Count width, Count height, Region&);
+   bool Fit(const Page&, Offset segment, Count width, Count height, Offset& y) const noexcept;
+   bool Place(Page&, Count width, Count height, Offset& x, Offset& y) const;
+};
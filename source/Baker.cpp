@@ -0,0 +1,533 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Baker.hpp"
+#include <Langulus/Math/SimplexNoise.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+///                                                                           
+///   Compiled octave expression                                              
+///                                                                           
+/// A small stack machine, that evaluates the subset of GLSL the material     
+/// nodes generate for octaves - arithmetic, swizzles, vector constructors,   
+/// a handful of built-in functions, and simplex noise. Reading anything but  
+/// the octave parameters fails compilation, because it might change          
+///                                                                           
+struct NoiseBaker::Program {
+   // Value of up to four components, scalars are broadcast             
+   struct Value {
+      float mData[4] {};
+      Count mCount = 1;
+   };
+
+   enum class Op {
+      UV, Octave, Mass, Constant,
+      Negate, Add, Subtract, Multiply, Divide,
+      Swizzle, Call
+   };
+
+   struct Instruction {
+      Op mOp;
+      // The constant, or the swizzle indices                           
+      Value mValue {};
+      // The called function, and the number of its arguments           
+      Token mFunction {};
+      Count mArguments {};
+   };
+
+   static constexpr Count MaxDepth = 16;
+
+   ::std::vector<Instruction> mCode;
+
+   bool Compile(const Token&);
+   bool Execute(Vec2f uv, float octave, float mass, Value&) const noexcept;
+
+private:
+   Token mSource;
+   Offset mAt {};
+   Count mDepth {};
+   Count mMaxDepth {};
+
+   void Push(Instruction&&);
+   void SkipSpaces() noexcept;
+   bool Accept(char) noexcept;
+   Token Name() noexcept;
+   bool ParseExpression();
+   bool ParseTerm();
+   bool ParseUnary();
+   bool ParsePostfix();
+   bool ParsePrimary();
+};
+
+/// Functions, that octave expressions may call, and their number of          
+/// arguments - zero for vector constructors, that take any number            
+constexpr ::std::pair<Token, Count> OctaveFunctions[] {
+   {"vec2", 0}, {"vec3", 0}, {"vec4", 0}, {"float", 1},
+   {"SimplexNoise1", 1},
+   {"abs", 1}, {"sign", 1}, {"floor", 1}, {"fract", 1}, {"sqrt", 1},
+   {"sin", 1}, {"cos", 1},
+   {"mod", 2}, {"pow", 2}, {"min", 2}, {"max", 2}
+};
+
+/// Compile an octave expression                                              
+///   @param code - the GLSL expression                                       
+///   @return true if the expression was compiled                             
+bool NoiseBaker::Program::Compile(const Token& code) {
+   mCode.clear();
+   mSource = code;
+   mAt = mDepth = mMaxDepth = 0;
+   if (not ParseExpression())
+      return false;
+
+   SkipSpaces();
+   return mAt == mSource.size() and mDepth == 1 and mMaxDepth <= MaxDepth;
+}
+
+/// Add an instruction, keeping track of the stack depth it requires          
+///   @param instruction - the instruction to add                             
+void NoiseBaker::Program::Push(Instruction&& instruction) {
+   switch (instruction.mOp) {
+   case Op::UV: case Op::Octave: case Op::Mass: case Op::Constant:
+      mMaxDepth = ::std::max(mMaxDepth, ++mDepth);
+      break;
+   case Op::Add: case Op::Subtract: case Op::Multiply: case Op::Divide:
+      --mDepth;
+      break;
+   case Op::Call:
+      mDepth -= instruction.mArguments - 1;
+      break;
+   default:
+      break;
+   }
+
+   mCode.push_back(Forward<Instruction>(instruction));
+}
+
+void NoiseBaker::Program::SkipSpaces() noexcept {
+   while (mAt < mSource.size() and ::std::isspace(
+      static_cast<unsigned char>(mSource[mAt])))
+      ++mAt;
+}
+
+bool NoiseBaker::Program::Accept(char c) noexcept {
+   SkipSpaces();
+   if (mAt >= mSource.size() or mSource[mAt] != c)
+      return false;
+   ++mAt;
+   return true;
+}
+
+Token NoiseBaker::Program::Name() noexcept {
+   SkipSpaces();
+   const auto start = mAt;
+   while (mAt < mSource.size() and (mSource[mAt] == '_' or ::std::isalnum(
+      static_cast<unsigned char>(mSource[mAt]))))
+      ++mAt;
+   return mSource.substr(start, mAt - start);
+}
+
+/// Sums and differences                                                      
+bool NoiseBaker::Program::ParseExpression() {
+   if (not ParseTerm())
+      return false;
+
+   while (true) {
+      if (Accept('+')) {
+         if (not ParseTerm())
+            return false;
+         Push({Op::Add});
+      }
+      else if (Accept('-')) {
+         if (not ParseTerm())
+            return false;
+         Push({Op::Subtract});
+      }
+      else return true;
+   }
+}
+
+/// Products and quotients                                                    
+bool NoiseBaker::Program::ParseTerm() {
+   if (not ParseUnary())
+      return false;
+
+   while (true) {
+      if (Accept('*')) {
+         if (not ParseUnary())
+            return false;
+         Push({Op::Multiply});
+      }
+      else if (Accept('/')) {
+         if (not ParseUnary())
+            return false;
+         Push({Op::Divide});
+      }
+      else return true;
+   }
+}
+
+/// Negation                                                                  
+bool NoiseBaker::Program::ParseUnary() {
+   if (Accept('-')) {
+      if (not ParseUnary())
+         return false;
+      Push({Op::Negate});
+      return true;
+   }
+   return ParsePostfix();
+}
+
+/// Swizzles                                                                  
+bool NoiseBaker::Program::ParsePostfix() {
+   if (not ParsePrimary())
+      return false;
+
+   while (Accept('.')) {
+      const auto name = Name();
+      if (name.empty() or name.size() > 4)
+         return false;
+
+      Instruction swizzle {Op::Swizzle};
+      swizzle.mValue.mCount = name.size();
+      for (Offset i = 0; i < name.size(); ++i) {
+         auto index = Token {"xyzw"}.find(name[i]);
+         if (index == Token::npos)
+            index = Token {"rgba"}.find(name[i]);
+         if (index == Token::npos)
+            return false;
+         swizzle.mValue.mData[i] = static_cast<float>(index);
+      }
+      Push(Move(swizzle));
+   }
+   return true;
+}
+
+/// Numbers, brackets, function calls, and the octave parameters              
+bool NoiseBaker::Program::ParsePrimary() {
+   if (Accept('('))
+      return ParseExpression() and Accept(')');
+
+   SkipSpaces();
+   if (mAt >= mSource.size())
+      return false;
+
+   const auto c = static_cast<unsigned char>(mSource[mAt]);
+   if (::std::isdigit(c) or c == '.') {
+      // Number literal                                                 
+      const ::std::string literal {mSource.substr(mAt)};
+      char* end {};
+      Instruction constant {Op::Constant};
+      constant.mValue.mData[0] = ::std::strtof(literal.c_str(), &end);
+      if (end == literal.c_str())
+         return false;
+
+      mAt += end - literal.c_str();
+      if (mAt < mSource.size() and (mSource[mAt] == 'f' or mSource[mAt] == 'F'))
+         ++mAt;
+      Push(Move(constant));
+      return true;
+   }
+
+   const auto name = Name();
+   if (name.empty())
+      return false;
+
+   if (Accept('(')) {
+      // Function call                                                  
+      Count arguments = 0;
+      if (not Accept(')')) {
+         do {
+            if (not ParseExpression())
+               return false;
+            ++arguments;
+         }
+         while (Accept(','));
+
+         if (not Accept(')'))
+            return false;
+      }
+
+      const auto function = ::std::find_if(
+         ::std::begin(OctaveFunctions), ::std::end(OctaveFunctions),
+         [&](const auto& f) { return f.first == name; });
+      if (function == ::std::end(OctaveFunctions) or not arguments)
+         return false;
+      if (function->second and function->second != arguments)
+         return false;
+
+      Instruction call {Op::Call};
+      call.mFunction = function->first;
+      call.mArguments = arguments;
+      Push(Move(call));
+      return true;
+   }
+
+   // Only the octave's own parameters may be read - anything else,     
+   // like time, or the result of another node, may change              
+   if (name == "uv")
+      Push({Op::UV});
+   else if (name == "octave")
+      Push({Op::Octave});
+   else if (name == "mass")
+      Push({Op::Mass});
+   else
+      return false;
+   return true;
+}
+
+/// Execute the program                                                       
+///   @param uv - the coordinates                                             
+///   @param octave - the octave index                                        
+///   @param mass - the octave weight                                         
+///   @param result - [out] the value of the expression                       
+///   @return true if the expression was evaluated                            
+bool NoiseBaker::Program::Execute(Vec2f uv, float octave, float mass, Value& result) const noexcept {
+   Value stack[MaxDepth];
+   Count depth = 0;
+
+   // Apply an operation to each component, broadcasting scalars        
+   const auto componentwise = [](const Value* args, Count count, auto&& f, Value& out) {
+      out.mCount = 1;
+      for (Offset i = 0; i < count; ++i) {
+         if (args[i].mCount == 1)
+            continue;
+         if (out.mCount != 1 and out.mCount != args[i].mCount)
+            return false;
+         out.mCount = args[i].mCount;
+      }
+
+      for (Offset c = 0; c < out.mCount; ++c) {
+         float x[2] {};
+         for (Offset i = 0; i < count; ++i)
+            x[i] = args[i].mData[args[i].mCount == 1 ? 0 : c];
+         out.mData[c] = f(x[0], x[1]);
+      }
+      return true;
+   };
+
+   for (auto& instruction : mCode) {
+      switch (instruction.mOp) {
+      case Op::UV:
+         stack[depth++] = {{uv[0], uv[1]}, 2};
+         break;
+      case Op::Octave:
+         stack[depth++] = {{octave}, 1};
+         break;
+      case Op::Mass:
+         stack[depth++] = {{mass}, 1};
+         break;
+      case Op::Constant:
+         stack[depth++] = instruction.mValue;
+         break;
+
+      case Op::Negate:
+         for (auto& component : stack[depth - 1].mData)
+            component = -component;
+         break;
+
+      case Op::Add: case Op::Subtract: case Op::Multiply: case Op::Divide: {
+         const auto op = instruction.mOp;
+         Value out;
+         if (not componentwise(stack + depth - 2, 2, [op](float a, float b) {
+            return op == Op::Add      ? a + b
+                 : op == Op::Subtract ? a - b
+                 : op == Op::Multiply ? a * b
+                 :                      a / b;
+         }, out)) return false;
+         stack[--depth - 1] = out;
+         break;
+      }
+
+      case Op::Swizzle: {
+         const auto& from = stack[depth - 1];
+         Value out;
+         out.mCount = instruction.mValue.mCount;
+         for (Offset i = 0; i < out.mCount; ++i) {
+            const auto index = static_cast<Offset>(instruction.mValue.mData[i]);
+            if (index >= from.mCount)
+               return false;
+            out.mData[i] = from.mData[index];
+         }
+         stack[depth - 1] = out;
+         break;
+      }
+
+      case Op::Call: {
+         const auto f = instruction.mFunction;
+         const auto count = instruction.mArguments;
+         const Value* args = stack + depth - count;
+         Value out;
+
+         if (f.starts_with("vec")) {
+            // Vector constructor, from components or a single scalar   
+            out.mCount = static_cast<Count>(f[3] - '0');
+            if (count == 1 and args[0].mCount == 1) {
+               for (Offset i = 0; i < out.mCount; ++i)
+                  out.mData[i] = args[0].mData[0];
+            }
+            else {
+               Offset c = 0;
+               for (Offset i = 0; i < count; ++i) {
+                  for (Offset j = 0; j < args[i].mCount; ++j) {
+                     if (c == out.mCount)
+                        return false;
+                     out.mData[c++] = args[i].mData[j];
+                  }
+               }
+               if (c != out.mCount)
+                  return false;
+            }
+         }
+         else if (f == "float")
+            out = {{args[0].mData[0]}, 1};
+         else if (f == "SimplexNoise1") {
+            const auto& p = args[0];
+            if (p.mCount == 2)
+               out.mData[0] = TSimplex<1, 2, float>::Noise(Vec2f {p.mData[0], p.mData[1]});
+            else if (p.mCount == 3)
+               out.mData[0] = TSimplex<1, 3, float>::Noise(Vec3f {p.mData[0], p.mData[1], p.mData[2]});
+            else
+               return false;
+         }
+         else {
+            // Built-in functions, that apply to each component         
+            bool success = false;
+            if      (f == "abs")   success = componentwise(args, 1, [](float a, float) { return ::std::abs(a); }, out);
+            else if (f == "sign")  success = componentwise(args, 1, [](float a, float) { return float((a > 0) - (a < 0)); }, out);
+            else if (f == "floor") success = componentwise(args, 1, [](float a, float) { return ::std::floor(a); }, out);
+            else if (f == "fract") success = componentwise(args, 1, [](float a, float) { return a - ::std::floor(a); }, out);
+            else if (f == "sqrt")  success = componentwise(args, 1, [](float a, float) { return ::std::sqrt(a); }, out);
+            else if (f == "sin")   success = componentwise(args, 1, [](float a, float) { return ::std::sin(a); }, out);
+            else if (f == "cos")   success = componentwise(args, 1, [](float a, float) { return ::std::cos(a); }, out);
+            else if (f == "mod")   success = componentwise(args, 2, [](float a, float b) { return a - b * ::std::floor(a / b); }, out);
+            else if (f == "pow")   success = componentwise(args, 2, [](float a, float b) { return ::std::pow(a, b); }, out);
+            else if (f == "min")   success = componentwise(args, 2, [](float a, float b) { return ::std::min(a, b); }, out);
+            else if (f == "max")   success = componentwise(args, 2, [](float a, float b) { return ::std::max(a, b); }, out);
+            if (not success)
+               return false;
+         }
+
+         depth -= count;
+         stack[depth++] = out;
+         break;
+      }
+      }
+   }
+
+   result = stack[0];
+   return depth == 1;
+}
+
+/// Check if an octave expression is time-invariant, and can be evaluated     
+/// on the CPU - it must read nothing but uv, octave and mass, call nothing   
+/// but the functions the baker knows, and result in a scalar                 
+///   @param octave - the octave expression                                   
+///   @return true if the octave can be baked                                 
+bool NoiseBaker::IsBakeable(const Token& octave) {
+   Program program;
+   Program::Value value;
+   return program.Compile(octave)
+      and program.Execute({0.5f, 0.5f}, 0, 0.5f, value)
+      and value.mCount == 1;
+}
+
+/// Get the number of mip levels, down to a single pixel                      
+///   @return the number of mip levels                                        
+auto NoiseBaker::GetMipCount() const noexcept -> Count {
+   Count count = 1;
+   for (auto size = mSize; size > 1; size /= 2)
+      ++count;
+   return count;
+}
+
+/// Evaluate the FBM at a point, mirroring FBMTemplate and FBMRotate          
+///   @param octave - the compiled octave expression                          
+///   @param uv - the point to evaluate at                                    
+///   @return the FBM value                                                   
+float NoiseBaker::Evaluate(const Program& octave, Vec2f uv) const noexcept {
+   float f = 0;
+   float weight = static_cast<float>(mBaseWeight);
+   for (Offset i = 0; i < mOctaves; ++i) {
+      Program::Value value;
+      octave.Execute(uv, static_cast<float>(i), weight, value);
+      f += weight * value.mData[0];
+      uv = Vec2f {1.6f * uv[0] - 1.2f * uv[1], 1.2f * uv[0] + 1.6f * uv[1]};
+      weight *= static_cast<float>(mBaseWeight);
+   }
+   return f;
+}
+
+/// Bake the noise and all of its mip levels                                  
+/// The four corners of the domain are blended bilinearly, so that the        
+/// texture wraps around seamlessly                                           
+///   @return the pixels of all mip levels, the largest one first             
+auto NoiseBaker::Bake() const -> TMany<float> {
+   LANGULUS_ASSERT(mSize and (mSize & (mSize - 1)) == 0, Material,
+      "Baked texture size must be a power of two", mSize);
+   LANGULUS_ASSERT(IsBakeable(static_cast<Token>(mOctave)), Material,
+      "Octave can't be baked", mOctave);
+
+   Program octave;
+   octave.Compile(static_cast<Token>(mOctave));
+
+   Count total = 0;
+   for (auto size = mSize; size; size /= 2)
+      total += size * size;
+
+   TMany<float> pixels;
+   pixels.New(total);
+
+   // Evaluate the largest level, one row at a time, in parallel        
+   const auto inverse = 1.0f / static_cast<float>(mSize);
+   ::std::atomic<Offset> next {0};
+   const auto worker = [&] {
+      Offset y;
+      while ((y = next++) < mSize) {
+         float* row = pixels.GetRaw() + y * mSize;
+         const float v = static_cast<float>(y) * inverse;
+         for (Offset x = 0; x < mSize; ++x) {
+            const float u = static_cast<float>(x) * inverse;
+            row[x] = Evaluate(octave, {u, v})         * (1 - u) * (1 - v)
+                   + Evaluate(octave, {u - 1, v})     * u       * (1 - v)
+                   + Evaluate(octave, {u, v - 1})     * (1 - u) * v
+                   + Evaluate(octave, {u - 1, v - 1}) * u       * v;
+         }
+      }
+   };
+
+   const auto threadCount = ::std::min<Count>(mSize,
+      ::std::max(1u, ::std::thread::hardware_concurrency()));
+   ::std::vector<::std::thread> threads;
+   for (Offset i = 1; i < threadCount; ++i)
+      threads.emplace_back(worker);
+   worker();
+   for (auto& thread : threads)
+      thread.join();
+
+   // Box-filter each next level from the previous one                  
+   Offset source = 0;
+   for (auto size = mSize / 2; size; size /= 2) {
+      const auto destination = source + size * size * 4;
+      for (Offset y = 0; y < size; ++y) {
+         for (Offset x = 0; x < size; ++x) {
+            const float* a = pixels.GetRaw() + source + (y * 2) * size * 2 + x * 2;
+            const float* b = a + size * 2;
+            pixels[destination + y * size + x] = (a[0] + a[1] + b[0] + b[1]) * 0.25f;
+         }
+      }
+      source = destination;
+   }
+
+   return pixels;
+}
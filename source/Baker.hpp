@@ -0,0 +1,46 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+
+
+///                                                                           
+///   Procedural noise baker                                                  
+///                                                                           
+/// Evaluates an FBM on the CPU, the same way the FBM node evaluates it in    
+/// shaders, over the [0; 1) texture coordinate range. The result is          
+/// accompanied by a full mipmap chain, so that it can replace the            
+/// procedural code with a single texture fetch.                              
+/// The octave is given as the GLSL expression the FBM node compiled. Only    
+/// expressions, that read nothing but the octave's own parameters - uv,      
+/// octave and mass - are time-invariant, and can be baked; see IsBakeable.   
+/// The four corners of the domain are blended bilinearly, so that the        
+/// texture tiles. This changes the look - contrast drops towards the middle  
+/// of the texture, where all four corners contribute equally.                
+/// Texels are evaluated one at a time, because simplex noise has no vector   
+/// form on the CPU. Rows are distributed among all hardware threads instead  
+///                                                                           
+struct NoiseBaker {
+   // Width and height of the largest mip level, must be a power of two 
+   Count mSize {256};
+   // Number of FBM octaves                                             
+   Count mOctaves {2};
+   // Weight of the first octave, each next one is multiplied by it     
+   Real mBaseWeight {0.5};
+   // The octave expression, plain simplex noise of uv by default       
+   Text mOctave {"SimplexNoise1(uv)"};
+
+   static bool IsBakeable(const Token&);
+
+   auto GetMipCount() const noexcept -> Count;
+   auto Bake() const -> TMany<float>;
+
+private:
+   struct Program;
+   float Evaluate(const Program&, Vec2f) const noexcept;
+};
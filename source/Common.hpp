@@ -15,6 +15,38 @@ struct MaterialLibrary;
 struct Material;
 struct Node;
 
+/// Traits, that are specific to material nodes                               
+LANGULUS_DEFINE_TRAIT(Compressed,
+   "Whether or not node data should be stored in a compact, quantized form");
+LANGULUS_DEFINE_TRAIT(Repeat,
+   "Period of domain repetition, for repeating a geometry infinitely");
+LANGULUS_DEFINE_TRAIT(Variation,
+   "Amplitude of pseudo-random variation between repeated elements");
+LANGULUS_DEFINE_TRAIT(Setup,
+   "Whether or not per-primitive setup is precomputed in a compute stage");
+LANGULUS_DEFINE_TRAIT(Tile,
+   "Size of screen tiles in pixels, for binning or low-resolution passes");
+LANGULUS_DEFINE_TRAIT(Thickness,
+   "Thickness of rasterized lines in pixels");
+LANGULUS_DEFINE_TRAIT(Strategy,
+   "Name of the algorithm a node uses, when more than one is available");
+LANGULUS_DEFINE_TRAIT(Downsample,
+   "Factor, by which a node reduces the resolution it works at");
+LANGULUS_DEFINE_TRAIT(ProjectedView,
+   "Combined view and projection transformation of a camera");
+LANGULUS_DEFINE_TRAIT(Unroll,
+   "Maximum number of iterations, that are unrolled instead of looped");
+LANGULUS_DEFINE_TRAIT(Derivative,
+   "Rate of change of a value along the horizontal and vertical pixel axes");
+LANGULUS_DEFINE_TRAIT(Draw,
+   "Number of vertices and instances, that a material draws without buffers");
+LANGULUS_DEFINE_TRAIT(Storage,
+   "Storage buffers and images, that are shared between shader stages");
+LANGULUS_DEFINE_TRAIT(Dispatch,
+   "Number of work groups, that a compute stage is dispatched with");
+LANGULUS_DEFINE_TRAIT(Atlas,
+   "Pages of the shared texture atlas, that samplers are bound to");
+
 #if 0
    #define VERBOSE_NODE(...)     Logger::Verbose(Self(), __VA_ARGS__)
    #define VERBOSE_NODE_TAB(...) const auto tab = Logger::VerboseTab(Self(), __VA_ARGS__)
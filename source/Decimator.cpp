@@ -0,0 +1,628 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Decimator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+   ///                                                                        
+   ///   Symmetric 4x4 error quadric, stored as its upper triangle            
+   ///                                                                        
+   struct Quadric {
+      double m[10] {};
+
+      Quadric() = default;
+
+      /// Make a quadric from a plane equation                                
+      ///   @param n - plane normal                                           
+      ///   @param d - plane distance                                         
+      ///   @param w - weight of the plane                                    
+      Quadric(const Vec3d& n, double d, double w) {
+         m[0] = w * n[0] * n[0]; m[1] = w * n[0] * n[1]; m[2] = w * n[0] * n[2]; m[3] = w * n[0] * d;
+                                 m[4] = w * n[1] * n[1]; m[5] = w * n[1] * n[2]; m[6] = w * n[1] * d;
+                                                         m[7] = w * n[2] * n[2]; m[8] = w * n[2] * d;
+                                                                                 m[9] = w * d * d;
+      }
+
+      Quadric& operator += (const Quadric& rhs) noexcept {
+         for (int i = 0; i < 10; ++i)
+            m[i] += rhs.m[i];
+         return *this;
+      }
+
+      /// Compute the error of placing a vertex at a given point              
+      ///   @param p - the point                                              
+      ///   @return the error                                                 
+      double Error(const Vec3d& p) const noexcept {
+         const double x = p[0], y = p[1], z = p[2];
+         return m[0] * x * x + 2 * m[1] * x * y + 2 * m[2] * x * z + 2 * m[3] * x
+              + m[4] * y * y + 2 * m[5] * y * z + 2 * m[6] * y
+              + m[7] * z * z + 2 * m[8] * z
+              + m[9];
+      }
+
+      /// Determinant of a 3x3 minor, used to find the optimal vertex         
+      double Det(int a11, int a12, int a13,
+                 int a21, int a22, int a23,
+                 int a31, int a32, int a33) const noexcept {
+         return m[a11] * m[a22] * m[a33] + m[a13] * m[a21] * m[a32]
+              + m[a12] * m[a23] * m[a31] - m[a13] * m[a22] * m[a31]
+              - m[a11] * m[a23] * m[a32] - m[a12] * m[a21] * m[a33];
+      }
+   };
+
+   /// A welded vertex                                                        
+   /// Texture coordinates are kept in faces, because vertices on texture     
+   /// seams have different ones on each side - such vertices are locked      
+   struct Vertex {
+      Vec3d mPosition;
+      Quadric mQuadric;
+      Offset mRefStart {};
+      Count mRefCount {};
+      bool mLocked {};
+   };
+
+   /// A face, referencing welded vertices                                    
+   struct Face {
+      Offset mVertices[3] {};
+      Vec2 mUV[3];
+      Vec3 mNormal;
+      double mError[4] {};
+      bool mDeleted {};
+      bool mDirty {};
+   };
+
+   /// A reference from a vertex to one of the faces that use it              
+   struct Reference {
+      Offset mFace {};
+      Offset mCorner {};
+   };
+
+   /// Triangle soup, welded into an indexed mesh, and simplified in place    
+   /// Meshes are processed inside worker threads, so they use standard       
+   /// containers, and never touch the framework's memory manager             
+   struct Mesh {
+      ::std::vector<Vertex> mVertexList;
+      ::std::vector<Face> mFaceList;
+      ::std::vector<Reference> mReferences;
+
+      void Weld(const Decimator::Triangles&, const Offset*, Count);
+      void ComputeQuadrics();
+      void LockBorders();
+      void UpdateReferences();
+      void Compact();
+      auto EdgeError(Offset, Offset, Vec3d&) const -> double;
+      auto GetUV(Offset) const -> Vec2;
+      bool Flipped(const Vec3d&, Offset, Offset, ::std::vector<bool>&) const;
+      void UpdateFaces(Offset, Offset, const Vec2&, const ::std::vector<bool>&, Count&);
+      void Simplify(Count, Real);
+      void Write(::std::vector<Decimator::Triangle>&) const;
+   };
+
+   /// Weld triangle corners with identical positions into shared vertices    
+   /// Corners with identical positions, but different texture coordinates,   
+   /// are on a texture seam, so their vertex is locked                       
+   ///   @param soup - all triangles                                          
+   ///   @param indices - the indices of triangles that are in the cluster    
+   ///   @param count - number of indices                                     
+   void Mesh::Weld(const Decimator::Triangles& soup, const Offset* indices, Count count) {
+      // Sort all corners by position, so that equal ones are adjacent  
+      struct Corner {
+         Vec3 mPosition;
+         Offset mFace;
+         Offset mCorner;
+      };
+
+      ::std::vector<Corner> corners;
+      corners.reserve(count * 3);
+      mFaceList.resize(count);
+      for (Offset i = 0; i < count; ++i) {
+         const auto& t = soup[indices[i]];
+         auto& f = mFaceList[i];
+         f.mUV[0] = t.aUV;
+         f.mUV[1] = t.bUV;
+         f.mUV[2] = t.cUV;
+         f.mNormal = t.n;
+         corners.push_back({t.a, i, 0});
+         corners.push_back({t.b, i, 1});
+         corners.push_back({t.c, i, 2});
+      }
+
+      ::std::sort(corners.begin(), corners.end(),
+         [](const Corner& lhs, const Corner& rhs) noexcept {
+            if (lhs.mPosition[0] != rhs.mPosition[0])
+               return lhs.mPosition[0] < rhs.mPosition[0];
+            if (lhs.mPosition[1] != rhs.mPosition[1])
+               return lhs.mPosition[1] < rhs.mPosition[1];
+            return lhs.mPosition[2] < rhs.mPosition[2];
+         }
+      );
+
+      Vec2 uv;
+      for (Offset i = 0; i < corners.size(); ++i) {
+         const auto& c = corners[i];
+         const auto& cornerUV = mFaceList[c.mFace].mUV[c.mCorner];
+         if (i == 0 or c.mPosition != corners[i - 1].mPosition) {
+            Vertex v;
+            v.mPosition = Vec3d {c.mPosition};
+            mVertexList.push_back(v);
+            uv = cornerUV;
+         }
+         else if (cornerUV != uv)
+            mVertexList.back().mLocked = true;
+
+         mFaceList[c.mFace].mVertices[c.mCorner] = mVertexList.size() - 1;
+      }
+   }
+
+   /// Accumulate area-weighted plane quadrics in all vertices                
+   void Mesh::ComputeQuadrics() {
+      for (auto& f : mFaceList) {
+         const auto& p0 = mVertexList[f.mVertices[0]].mPosition;
+         const auto& p1 = mVertexList[f.mVertices[1]].mPosition;
+         const auto& p2 = mVertexList[f.mVertices[2]].mPosition;
+         auto n = (p1 - p0).Cross(p2 - p0);
+         const auto area = n.Length();
+         if (area <= 0)
+            continue;
+
+         n /= area;
+         const Quadric q {n, -n.Dot(p0), area * 0.5};
+         for (auto v : f.mVertices)
+            mVertexList[v].mQuadric += q;
+      }
+   }
+
+   /// Lock vertices on open edges - these are either mesh borders, or        
+   /// cluster borders, and moving them would open cracks                     
+   void Mesh::LockBorders() {
+      UpdateReferences();
+
+      ::std::vector<Offset> neighbors;
+      ::std::vector<Count> uses;
+      for (auto& v : mVertexList) {
+         neighbors.clear();
+         uses.clear();
+
+         for (Offset r = 0; r < v.mRefCount; ++r) {
+            const auto& f = mFaceList[mReferences[v.mRefStart + r].mFace];
+            for (auto id : f.mVertices) {
+               Offset n = 0;
+               while (n < neighbors.size() and neighbors[n] != id)
+                  ++n;
+
+               if (n == neighbors.size()) {
+                  neighbors.push_back(id);
+                  uses.push_back(1);
+               }
+               else ++uses[n];
+            }
+         }
+
+         for (Offset n = 0; n < neighbors.size(); ++n) {
+            if (uses[n] == 1) {
+               v.mLocked = true;
+               mVertexList[neighbors[n]].mLocked = true;
+            }
+         }
+      }
+   }
+
+   /// Rebuild vertex -> face references                                      
+   void Mesh::UpdateReferences() {
+      for (auto& v : mVertexList) {
+         v.mRefStart = 0;
+         v.mRefCount = 0;
+      }
+
+      for (auto& f : mFaceList) {
+         for (auto id : f.mVertices)
+            ++mVertexList[id].mRefCount;
+      }
+
+      Offset start = 0;
+      for (auto& v : mVertexList) {
+         v.mRefStart = start;
+         start += v.mRefCount;
+         v.mRefCount = 0;
+      }
+
+      mReferences.resize(start);
+      for (Offset i = 0; i < mFaceList.size(); ++i) {
+         const auto& f = mFaceList[i];
+         for (Offset j = 0; j < 3; ++j) {
+            auto& v = mVertexList[f.mVertices[j]];
+            mReferences[v.mRefStart + v.mRefCount] = {i, j};
+            ++v.mRefCount;
+         }
+      }
+   }
+
+   /// Remove deleted faces, and recompute edge errors                        
+   void Mesh::Compact() {
+      mFaceList.erase(::std::remove_if(mFaceList.begin(), mFaceList.end(),
+         [](const Face& f) noexcept { return f.mDeleted; }),
+         mFaceList.end());
+
+      UpdateReferences();
+
+      for (auto& f : mFaceList) {
+         Vec3d p;
+         for (Offset j = 0; j < 3; ++j)
+            f.mError[j] = EdgeError(f.mVertices[j], f.mVertices[(j + 1) % 3], p);
+         f.mError[3] = ::std::min(f.mError[0], ::std::min(f.mError[1], f.mError[2]));
+      }
+   }
+
+   /// Compute the error of collapsing an edge                                
+   ///   @param a - first edge vertex                                         
+   ///   @param b - second edge vertex                                        
+   ///   @param result - [out] the optimal placement for the new vertex       
+   ///   @return the error introduced by the collapse                         
+   auto Mesh::EdgeError(Offset a, Offset b, Vec3d& result) const -> double {
+      const auto& va = mVertexList[a];
+      const auto& vb = mVertexList[b];
+      if (va.mLocked or vb.mLocked) {
+         // Locked edges are never collapsed                            
+         result = va.mPosition;
+         return ::std::numeric_limits<double>::max();
+      }
+
+      Quadric q = va.mQuadric;
+      q += vb.mQuadric;
+
+      const double det = q.Det(0, 1, 2, 1, 4, 5, 2, 5, 7);
+      if (::std::abs(det) > 1e-12) {
+         // The quadric is invertible, so use the optimal position      
+         result = Vec3d {
+            -1.0 / det * q.Det(1, 2, 3, 4, 5, 6, 5, 7, 8),
+             1.0 / det * q.Det(0, 2, 3, 1, 5, 6, 2, 7, 8),
+            -1.0 / det * q.Det(0, 1, 3, 1, 4, 6, 2, 5, 8)
+         };
+         return q.Error(result);
+      }
+
+      // Otherwise pick the best of the endpoints and the midpoint      
+      const auto mid = (va.mPosition + vb.mPosition) * 0.5;
+      const double ea = q.Error(va.mPosition);
+      const double eb = q.Error(vb.mPosition);
+      const double em = q.Error(mid);
+      const double best = ::std::min(ea, ::std::min(eb, em));
+      result = best == ea ? va.mPosition : best == eb ? vb.mPosition : mid;
+      return best;
+   }
+
+   /// Get the texture coordinates of an unlocked vertex                      
+   /// All of its faces agree on them, because seam vertices are locked       
+   ///   @param id - the vertex                                               
+   ///   @return the texture coordinates                                      
+   auto Mesh::GetUV(Offset id) const -> Vec2 {
+      const auto& v = mVertexList[id];
+      const auto& ref = mReferences[v.mRefStart];
+      return mFaceList[ref.mFace].mUV[ref.mCorner];
+   }
+
+   /// Check if moving a vertex would flip any of its faces                   
+   ///   @param p - the new position                                          
+   ///   @param i0 - the vertex being moved                                   
+   ///   @param i1 - the other end of the collapsed edge                      
+   ///   @param deleted - [out] marks faces that will degenerate              
+   ///   @return true if a face would flip                                    
+   bool Mesh::Flipped(const Vec3d& p, Offset i0, Offset i1, ::std::vector<bool>& deleted) const {
+      const auto& v0 = mVertexList[i0];
+      for (Offset r = 0; r < v0.mRefCount; ++r) {
+         const auto& ref = mReferences[v0.mRefStart + r];
+         const auto& f = mFaceList[ref.mFace];
+         if (f.mDeleted)
+            continue;
+
+         const auto id1 = f.mVertices[(ref.mCorner + 1) % 3];
+         const auto id2 = f.mVertices[(ref.mCorner + 2) % 3];
+         if (id1 == i1 or id2 == i1) {
+            // Face shares the collapsed edge, and will be removed      
+            deleted[r] = true;
+            continue;
+         }
+
+         deleted[r] = false;
+         const auto& p1 = mVertexList[id1].mPosition;
+         const auto& p2 = mVertexList[id2].mPosition;
+
+         // Compare against the face as it currently is, because the    
+         // stored normal is outdated after earlier collapses           
+         auto before = (p1 - v0.mPosition).Cross(p2 - v0.mPosition);
+         const auto bl = before.Length();
+         if (bl <= 0)
+            continue;
+         before /= bl;
+
+         auto d1 = p1 - p;
+         auto d2 = p2 - p;
+         const auto l1 = d1.Length();
+         const auto l2 = d2.Length();
+         if (l1 <= 0 or l2 <= 0)
+            return true;
+
+         d1 /= l1;
+         d2 /= l2;
+         if (::std::abs(d1.Dot(d2)) > 0.999)
+            return true;
+
+         auto n = d1.Cross(d2);
+         const auto nl = n.Length();
+         if (nl <= 0)
+            return true;
+
+         n /= nl;
+         if (n.Dot(before) < 0.2)
+            return true;
+      }
+
+      return false;
+   }
+
+   /// Redirect the faces of a collapsed vertex to the surviving one          
+   ///   @param i0 - the surviving vertex                                     
+   ///   @param from - the collapsed vertex                                   
+   ///   @param uv - texture coordinates of the surviving vertex              
+   ///   @param deleted - faces that degenerate after the collapse            
+   ///   @param removed - [in/out] counter for removed faces                  
+   void Mesh::UpdateFaces(Offset i0, Offset from, const Vec2& uv, const ::std::vector<bool>& deleted, Count& removed) {
+      auto& v = mVertexList[from];
+      for (Offset r = 0; r < v.mRefCount; ++r) {
+         const auto ref = mReferences[v.mRefStart + r];
+         auto& f = mFaceList[ref.mFace];
+         if (f.mDeleted)
+            continue;
+
+         if (deleted[r]) {
+            f.mDeleted = true;
+            ++removed;
+            continue;
+         }
+
+         f.mVertices[ref.mCorner] = i0;
+         f.mUV[ref.mCorner] = uv;
+         f.mDirty = true;
+
+         Vec3d p;
+         for (Offset j = 0; j < 3; ++j)
+            f.mError[j] = EdgeError(f.mVertices[j], f.mVertices[(j + 1) % 3], p);
+         f.mError[3] = ::std::min(f.mError[0], ::std::min(f.mError[1], f.mError[2]));
+         mReferences.push_back(ref);
+      }
+   }
+
+   /// Collapse edges until the budget is met, or the error is too large      
+   /// Uses an increasing error threshold per pass, instead of a priority     
+   /// queue, which is a lot faster and yields very similar results           
+   ///   @param budget - target number of faces, zero for none                
+   ///   @param maxError - maximum allowed error, zero for none               
+   void Mesh::Simplify(Count budget, Real maxError) {
+      ComputeQuadrics();
+      LockBorders();
+
+      const auto initial = mFaceList.size();
+      Count removed = 0;
+      ::std::vector<bool> deleted0, deleted1;
+
+      for (int pass = 0; pass < 100; ++pass) {
+         if (budget and initial - removed <= budget)
+            break;
+
+         // Periodically get rid of deleted faces                       
+         if (pass % 5 == 0)
+            Compact();
+
+         for (auto& f : mFaceList)
+            f.mDirty = false;
+
+         // The threshold grows with each pass                          
+         double threshold = 1e-9 * ::std::pow(double(pass + 3), 7.0);
+         if (maxError > 0 and threshold > maxError)
+            threshold = maxError;
+
+         const auto removedBefore = removed;
+         for (Offset i = 0; i < mFaceList.size(); ++i) {
+            auto& f = mFaceList[i];
+            if (f.mError[3] > threshold or f.mDeleted or f.mDirty)
+               continue;
+
+            for (Offset j = 0; j < 3; ++j) {
+               if (f.mError[j] > threshold)
+                  continue;
+
+               const auto i0 = f.mVertices[j];
+               const auto i1 = f.mVertices[(j + 1) % 3];
+               auto& v0 = mVertexList[i0];
+               auto& v1 = mVertexList[i1];
+
+               Vec3d p;
+               EdgeError(i0, i1, p);
+
+               deleted0.assign(v0.mRefCount, false);
+               deleted1.assign(v1.mRefCount, false);
+               if (Flipped(p, i0, i1, deleted0) or Flipped(p, i1, i0, deleted1))
+                  continue;
+
+               // Texture coordinates are interpolated at the point's   
+               // projection on the collapsed edge                      
+               const auto edge = v1.mPosition - v0.mPosition;
+               const auto edgeLength = edge.Dot(edge);
+               const auto ratio = edgeLength > 0 ? ::std::clamp(
+                  (p - v0.mPosition).Dot(edge) / edgeLength, 0.0, 1.0) : 0.0;
+               const auto uv0 = GetUV(i0);
+               const Vec2 uv = uv0 + (GetUV(i1) - uv0) * Real(ratio);
+
+               // Collapse v1 into v0                                   
+               v0.mPosition = p;
+               v0.mQuadric += v1.mQuadric;
+
+               const auto start = mReferences.size();
+               UpdateFaces(i0, i0, uv, deleted0, removed);
+               UpdateFaces(i0, i1, uv, deleted1, removed);
+               v0.mRefStart = start;
+               v0.mRefCount = mReferences.size() - start;
+               break;
+            }
+
+            if (budget and initial - removed <= budget)
+               break;
+         }
+
+         // Stop if the error threshold was reached and nothing changed 
+         if (removed == removedBefore and maxError > 0 and threshold >= maxError)
+            break;
+      }
+
+      Compact();
+   }
+
+   /// Convert the simplified mesh back to triangles                          
+   /// Normals are recomputed from the final positions, because the welded    
+   /// ones are outdated after collapses. They stay on the side of the        
+   /// original normal, in case the source winding doesn't match it           
+   ///   @param output - [out] where triangles are pushed                     
+   void Mesh::Write(::std::vector<Decimator::Triangle>& output) const {
+      output.reserve(mFaceList.size());
+      for (auto& f : mFaceList) {
+         const Vec3 a {mVertexList[f.mVertices[0]].mPosition};
+         const Vec3 b {mVertexList[f.mVertices[1]].mPosition};
+         const Vec3 c {mVertexList[f.mVertices[2]].mPosition};
+
+         auto normal = (b - a).Cross(c - a);
+         const auto length = normal.Length();
+         if (length > 0) {
+            normal /= length;
+            if (normal.Dot(f.mNormal) < 0)
+               normal = -normal;
+         }
+         else normal = f.mNormal;
+
+         output.push_back({a, f.mUV[0], b, f.mUV[1], c, f.mUV[2], normal});
+      }
+   }
+
+} // namespace
+
+
+/// Check if decimation should be performed at all                            
+///   @return true if a budget or an error threshold is set                   
+bool Decimator::IsEnabled() const noexcept {
+   return mBudget > 0 or mMaxError > 0;
+}
+
+/// Simplify a list of triangles                                              
+///   @param input - the triangles to simplify                                
+///   @return the simplified triangles                                        
+auto Decimator::Simplify(const Triangles& input) const -> Triangles {
+   if (not IsEnabled() or not input or (mBudget and input.GetCount() <= mBudget))
+      return input;
+
+   // Split triangles in a grid of clusters, based on their centroids   
+   Vec3 min = input[0].a;
+   Vec3 max = input[0].a;
+   TMany<Vec3> centroids;
+   centroids.Reserve(input.GetCount());
+   for (auto& t : input) {
+      const Vec3 c = (t.a + t.b + t.c) / Real {3};
+      for (Offset i = 0; i < 3; ++i) {
+         min[i] = ::std::min(min[i], c[i]);
+         max[i] = ::std::max(max[i], c[i]);
+      }
+      centroids << c;
+   }
+
+   const Count cells = ::std::max(Count {1}, static_cast<Count>(::std::ceil(
+      ::std::cbrt(Real(input.GetCount()) / Real(mClusterSize)))));
+   const Vec3 extent = max - min;
+   const auto CellOf = [&](const Vec3& c) -> Offset {
+      Offset cell = 0;
+      for (Offset i = 0; i < 3; ++i) {
+         Offset x = 0;
+         if (extent[i] > 0) {
+            x = static_cast<Offset>((c[i] - min[i]) / extent[i] * cells);
+            x = ::std::min(x, cells - 1);
+         }
+         cell = cell * cells + x;
+      }
+      return cell;
+   };
+
+   // Counting sort of triangle indices by cluster                      
+   const Count clusterCount = cells * cells * cells;
+   TMany<Offset> clusterStart;
+   clusterStart.New(clusterCount + 1, Offset {0});
+   TMany<Offset> cellOf;
+   cellOf.Reserve(input.GetCount());
+   for (auto& c : centroids) {
+      const auto cell = CellOf(c);
+      cellOf << cell;
+      ++clusterStart[cell + 1];
+   }
+
+   for (Offset i = 0; i < clusterCount; ++i)
+      clusterStart[i + 1] += clusterStart[i];
+
+   TMany<Offset> order;
+   order.New(input.GetCount());
+   // Insertion cursors are copied to a separate buffer, because        
+   // assigning containers only references the same memory              
+   ::std::vector<Offset> fill (clusterStart.GetRaw(),
+      clusterStart.GetRaw() + clusterStart.GetCount());
+   for (Offset i = 0; i < input.GetCount(); ++i)
+      order[fill[cellOf[i]]++] = i;
+
+   // Simplify all clusters in parallel                                 
+   ::std::vector<::std::vector<Triangle>> results(clusterCount);
+   ::std::atomic<Offset> next {0};
+   const auto worker = [&] {
+      Offset cluster;
+      while ((cluster = next++) < clusterCount) {
+         const auto start = clusterStart[cluster];
+         const auto count = clusterStart[cluster + 1] - start;
+         if (not count)
+            continue;
+
+         // Distribute the triangle budget proportionally               
+         Count budget = 0;
+         if (mBudget) {
+            budget = ::std::max(Count {1},
+               (mBudget * count + input.GetCount() - 1) / input.GetCount());
+         }
+
+         Mesh mesh;
+         mesh.Weld(input, order.GetRaw() + start, count);
+         mesh.Simplify(budget, mMaxError);
+         mesh.Write(results[cluster]);
+      }
+   };
+
+   const auto threadCount = ::std::min<Count>(clusterCount,
+      ::std::max(1u, ::std::thread::hardware_concurrency()));
+   ::std::vector<::std::thread> threads;
+   for (Offset i = 1; i < threadCount; ++i)
+      threads.emplace_back(worker);
+   worker();
+   for (auto& thread : threads)
+      thread.join();
+
+   // Concatenate, preserving cluster order for deterministic output    
+   Triangles output;
+   for (auto& result : results) {
+      for (auto& t : result)
+         output << t;
+   }
+   return output;
+}
@@ -0,0 +1,36 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "nodes/Scene.hpp"
+
+
+///                                                                           
+///   Quadric error metric mesh simplifier                                    
+///                                                                           
+/// Reduces the number of triangles in a scene by collapsing the edges that   
+/// introduce the least geometric error. Triangles are split into spatial     
+/// clusters, that are simplified in parallel. Vertices on cluster borders    
+/// are locked, so that no cracks appear between neighboring clusters, and    
+/// so are vertices on texture seams, so that their coordinates stay intact   
+///                                                                           
+struct Decimator {
+   using Triangle  = Nodes::Scene::Triangle;
+   using Triangles = TMany<Triangle>;
+
+   // Target number of triangles, zero for no budget                    
+   Count mBudget {};
+   // Maximum allowed quadric error, zero for no threshold - that's     
+   // the sum of squared distances to the original faces' planes,       
+   // weighted by their areas                                           
+   Real mMaxError {};
+   // Approximate number of triangles in a single cluster               
+   Count mClusterSize {2048};
+
+   bool IsEnabled() const noexcept;
+   auto Simplify(const Triangles&) const -> Triangles;
+};
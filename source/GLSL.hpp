@@ -131,7 +131,24 @@ private:
       )shader",
 
       // ShaderStage::Compute                                           
-      ""
+      R"shader(
+      //#VERSION
+
+      //#DEFINES
+
+      //#INPUT
+
+      //#OUTPUT
+
+      //#UNIFORM
+
+      //#FUNCTIONS
+
+      void main () {
+         //#TRANSFORM
+
+      }
+      )shader"
    };
 
 public:
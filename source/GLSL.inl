@@ -216,6 +216,10 @@ inline GLSL GLSL::Type(DMeta meta) {
 
       return token;
    }
+   else if (meta->template Is<TMany<A::Image*>>()) {
+      // Images, that are bound as layers of a single texture           
+      return "sampler2DArray";
+   }
    else if (meta->CastsTo<A::Image>()) {
       return "sampler2D";
       //TODO distinguish these:
@@ -0,0 +1,78 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "ImageFile.hpp"
+#include <algorithm>
+
+
+/// Read the pixel format, that an image file decodes to, from the start of   
+/// the file. Only PNG files are recognized for now. Decoders expand          
+/// palettes and low bit depths to 8-bit channels, and transparency chunks    
+/// to an alpha channel, so the chunks up to the image data are scanned too   
+///   @param data - the start of the file                                     
+///   @param size - number of bytes available                                 
+///   @return the pixel format, or nullptr if not recognized                  
+auto ProbeImageFormat(const Byte* data, Size size) -> DMeta {
+   const auto at = [&](Offset i) { return static_cast<uint8_t>(data[i]); };
+
+   // PNG signature, followed by the IHDR chunk                         
+   constexpr uint8_t signature[] {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+   constexpr Offset firstChunk = 33;
+   if (size < firstChunk)
+      return {};
+   for (Offset i = 0; i < sizeof(signature); ++i) {
+      if (at(i) != signature[i])
+         return {};
+   }
+
+   // Look for transparency, up to the image data - if the image data   
+   // isn't reached, transparency might still follow                    
+   bool transparency = false;
+   bool complete = false;
+   for (Offset chunk = firstChunk; chunk + 8 <= size;) {
+      const Size length = (Size {at(chunk)} << 24) | (Size {at(chunk + 1)} << 16)
+                        | (Size {at(chunk + 2)} << 8) | Size {at(chunk + 3)};
+      const Token type {reinterpret_cast<const char*>(data + chunk + 4), 4};
+      if (type == "IDAT" or type == "IEND") {
+         complete = true;
+         break;
+      }
+
+      transparency |= type == "tRNS";
+      chunk += length + 12;
+   }
+   if (not complete)
+      return {};
+
+   const auto depth = at(24);
+   const auto color = at(25);
+   Count channels {};
+   switch (color) {
+   case 0:           channels = transparency ? 2 : 1; break;  // Greyscale
+   case 4:           channels = 2; break;                     // Greyscale with alpha
+   case 2: case 3:   channels = transparency ? 4 : 3; break;  // Truecolor or palette
+   case 6:           channels = 4; break;                     // Truecolor with alpha
+   default:          return {};
+   }
+
+   // Palette entries are always 8-bit colors                           
+   if (depth == 16 and color != 3) {
+      switch (channels) {
+      case 1:  return MetaOf<TVector<uint16_t, 1>>();
+      case 2:  return MetaOf<TVector<uint16_t, 2>>();
+      case 3:  return MetaOf<TVector<uint16_t, 3>>();
+      default: return MetaOf<TVector<uint16_t, 4>>();
+      }
+   }
+
+   switch (channels) {
+   case 1:  return MetaOf<TVector<uint8_t, 1>>();
+   case 2:  return MetaOf<TVector<uint8_t, 2>>();
+   case 3:  return MetaOf<TVector<uint8_t, 3>>();
+   default: return MetaOf<TVector<uint8_t, 4>>();
+   }
+}
@@ -0,0 +1,19 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+
+
+///                                                                           
+///   Image file helpers                                                      
+///                                                                           
+/// Plain functions of file contents, without any framework containers or     
+/// modules, so that they are safe to use on any thread. The files are read   
+/// through the framework file system by the Texture node                     
+///                                                                           
+auto ProbeImageFormat(const Byte*, Size) -> DMeta;
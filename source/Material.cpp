@@ -7,6 +7,7 @@
 ///                                                                           
 #include "Material.hpp"
 #include "MaterialLibrary.hpp"
+#include "nodes/Texture.hpp"
 #include <Langulus/Anyness/Edit.hpp>
 
 
@@ -60,6 +61,13 @@ void Material::Create(Verb& verb) {
    mRoot.Create(verb);
 }
 
+/// Attach the images of all textures, whose files have finished reading      
+void Material::Refresh() {
+   mRoot.ForEachChild([](Nodes::Texture& texture) {
+      texture.Attach(false);
+   });
+}
+
 /// Generate shaders                                                          
 ///   @param trait - the trait to generate                                    
 ///   @param index - trait group to generate                                  
@@ -75,6 +83,10 @@ bool Material::Generate(TMeta trait, Offset) {
    mDataListMap.Insert(trait);
    mDataListMap[trait].New(ShaderStage::Counter, GLSL {});
 
+   // Generate the node hierarchy, and the definitions it made          
+   mRoot.Generate();
+   GenerateDefinitions();
+
    // If a vertex shader is missing, add a default one                  
    GLSL& vs = GetStage(ShaderStage::Vertex);
    if (vs.IsEmpty()) {
@@ -86,6 +98,7 @@ bool Material::Generate(TMeta trait, Offset) {
    }
 
    // Generate inputs and outputs where needed                          
+   GenerateHoisted();
    GenerateInputs();
    GenerateOutputs();
    GenerateUniforms();
@@ -261,12 +274,294 @@ GLSL Material::AddOutput(RefreshRate rate, const Trait& t, bool allowDuplicates)
 }
 
 /// Adds a code snippet                                                       
+/// Only the first definition of a name is kept, so that nodes can safely     
+/// define their dependencies, even if others already did                     
 ///   @param rate - the shader stage to place code at                         
 ///   @param name - the name of the definition (to check for duplicated)      
 ///   @param code - the code to insert                                        
 void Material::AddDefine(RefreshRate rate, const Token& name, const GLSL& code) {
    const auto stageIndex = rate.GetStageIndex();
-   mDefinitions[stageIndex][name] << code;
+   const GLSL key {name};
+   if (mDefinitions[stageIndex].FindIt(key))
+      return;
+
+   mDefinitions[stageIndex].Insert(key, code);
+   mDefinitionOrder[stageIndex] << key;
+}
+
+/// Get the list of exposed data for a trait, creating it if missing          
+/// Material data, other than the shader code, tells the renderer how to      
+/// draw and dispatch the generated stages                                    
+///   @tparam T - the trait of the data                                       
+///   @return the data list                                                   
+template<CT::Trait T>
+auto& Material::GetExposed() {
+   const auto trait = MetaOf<T>();
+   if (not mDataListMap.FindIt(trait))
+      mDataListMap.Insert(trait);
+   return mDataListMap[trait];
+}
+
+/// Add a sampler for a shared texture atlas page                             
+/// All textures packed in the same page share that single sampler. The page  
+/// it's bound to is exposed as Traits::Atlas data                            
+///   @param page - the atlas page index                                      
+///   @param mips - the number of mip levels the page can be sampled at       
+///   @return the sampler name                                                
+GLSL Material::AddAtlas(Offset page, Count mips) {
+   auto& sampler = mAtlasSamplers[page];
+   if (not sampler) {
+      sampler = AddInput(Rate::Renderable,
+         Traits::Image::OfType<A::Image>(), true);
+      GetExposed<Traits::Atlas>() << Many {AtlasSampler {sampler, page, mips}};
+   }
+   return sampler;
+}
+
+/// Set the size of the draw call, for materials that pull their own          
+/// vertices, instead of reading them from bound vertex buffers               
+/// Exposed as Traits::Draw data - a Vec2u of vertices and instances          
+///   @param vertices - number of vertices per instance                       
+///   @param instances - number of instances                                  
+void Material::SetDraw(Count vertices, Count instances) {
+   auto& draw = GetExposed<Traits::Draw>();
+   draw.Reset();
+   draw << Many {Vec2u {vertices, instances}};
+   VERBOSE_NODE("Drawing ", vertices, " vertices x ", instances, " instances");
+}
+
+/// Set the work groups of the compute stage                                  
+/// There's only one compute stage, so all nodes, that add to it, must agree  
+/// on the dispatch. Exposed as Traits::Dispatch data                         
+///   @param dispatch - the work groups                                       
+void Material::SetDispatch(const ComputeDispatch& dispatch) {
+   auto& dispatches = GetExposed<Traits::Dispatch>();
+   if (dispatches) {
+      LANGULUS_ASSERT(dispatches[0].template As<ComputeDispatch>() == dispatch,
+         Material, "Compute stage is already dispatched differently");
+      return;
+   }
+
+   dispatches << Many {dispatch};
+   VERBOSE_NODE("Dispatching ", dispatch.mGroups, " work groups");
+}
+
+/// Add a storage buffer or image, shared between shader stages               
+/// Storage always uses layout set #3, with bindings assigned in order of     
+/// addition. Exposed as Traits::Storage data, one entry per binding          
+///   @param storage - the storage description                                
+///   @param allowDuplicates - whether multiple storages of that name are     
+///                            allowed, in which case the binding index is    
+///                            appended to the name, to tell them apart       
+///   @return the binding index                                               
+auto Material::AddStorage(const StorageBinding& storage, bool allowDuplicates) -> Offset {
+   auto& bindings = GetExposed<Traits::Storage>();
+   if (not allowDuplicates) {
+      for (Offset i = 0; i < bindings.GetCount(); ++i) {
+         if (bindings[i].template As<StorageBinding>().mName == storage.mName)
+            return i;
+      }
+   }
+
+   const auto binding = bindings.GetCount();
+   auto added = storage;
+   if (allowDuplicates)
+      added.mName = Text {storage.mName, binding};
+
+   bindings << Many {added};
+   VERBOSE_NODE("Added storage `", added.mName, "` at binding ", binding);
+   return binding;
+}
+
+/// Get the number of locations, that an interface variable occupies          
+/// A location holds four 32-bit components, so matrices take one location    
+/// per column, and 64-bit vectors of more than two components take two       
+///   @param meta - the decayed GLSL type                                     
+///   @return the number of locations                                         
+static Count GetLocationCount(DMeta meta) {
+   meta = meta->GetMostConcrete();
+   RTTI::Base base;
+   Count size = 1;
+   if (meta->GetBase<Double>(0, base))
+      size = 2;
+   else if (not meta->GetBase<Float>(0, base)
+        and not meta->GetBase<uint32_t>(0, base)
+        and not meta->GetBase<int32_t>(0, base))
+      return 1;
+
+   Count columns = 1;
+   RTTI::Base column;
+   if (meta->CastsTo<A::Matrix>() and meta->GetBase<A::Vector>(0, column))
+      columns = column.mCount;
+
+   const Count rows = base.mCount / columns;
+   return columns * ((rows * size + 3) / 4);
+}
+
+/// Check if a decayed GLSL type is an integer scalar or vector               
+///   @param meta - the decayed GLSL type                                     
+///   @return true if the type is made of integers                            
+static bool IsInteger(DMeta meta) {
+   RTTI::Base base;
+   meta = meta->GetMostConcrete();
+   return meta->GetBase<int32_t>(0, base) or meta->GetBase<uint32_t>(0, base);
+}
+
+/// Replace a name in code, but only where it is a whole word                 
+///   @param code - the code to search                                        
+///   @param what - the name to replace                                       
+///   @param with - the replacement                                           
+///   @return the code with the name replaced                                 
+static GLSL ReplaceKeyword(const GLSL& code, const Token& what, const Token& with) {
+   const auto isName = [](char c) {
+      return c == '_' or (c >= '0' and c <= '9')
+          or (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z');
+   };
+
+   const auto source = static_cast<Token>(code);
+   GLSL result;
+   Offset copied = 0;
+   for (auto at = source.find(what); at != Token::npos; at = source.find(what, at + what.size())) {
+      const auto end = at + what.size();
+      if ((at > 0 and isName(source[at - 1])) or (end < source.size() and isName(source[end])))
+         continue;
+
+      result += Text {source.substr(copied, at - copied), with};
+      copied = end;
+   }
+
+   result += Text {source.substr(copied)};
+   return result;
+}
+
+/// Check if a function is available in every shader stage                    
+/// These are type constructors, and built-in functions, that don't depend on 
+/// implicit derivatives                                                      
+///   @param name - the function name                                         
+///   @return true if the function is available in every stage                
+static bool IsBuiltIn(const Token& name) {
+   constexpr Token constructors[] {
+      "bool", "int", "uint", "float", "double",
+      "vec", "ivec", "uvec", "bvec", "dvec", "mat", "dmat"
+   };
+
+   for (auto type : constructors) {
+      if (name.starts_with(type))
+         return true;
+   }
+
+   constexpr Token functions[] {
+      "abs", "sign", "floor", "ceil", "round", "trunc", "fract", "mod",
+      "min", "max", "clamp", "mix", "step", "smoothstep",
+      "sqrt", "inversesqrt", "pow", "exp", "exp2", "log", "log2",
+      "sin", "cos", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh",
+      "radians", "degrees", "length", "distance", "dot", "cross",
+      "normalize", "reflect", "refract", "faceforward",
+      "transpose", "inverse", "determinant", "outerProduct",
+      "matrixCompMult", "lessThan", "lessThanEqual", "greaterThan",
+      "greaterThanEqual", "equal", "notEqual", "any", "all", "not",
+      "floatBitsToInt", "floatBitsToUint", "intBitsToFloat",
+      "uintBitsToFloat"
+   };
+
+   for (auto function : functions) {
+      if (name == function)
+         return true;
+   }
+
+   return false;
+}
+
+/// Copy the definitions, that an expression depends on, from one stage to    
+/// another, so that the expression can be moved there                        
+/// Expressions that call functions, which are neither built-in, nor defined  
+/// for the source stage, are left where they are                             
+///   @param from - the stage the expression is consumed in                   
+///   @param to - the stage the expression is moved to                        
+///   @param code - the expression                                            
+///   @return true if the expression can be moved                             
+bool Material::Transplant(RefreshRate from, RefreshRate to, const GLSL& code) {
+   const auto& definitions = mDefinitions[from.GetStageIndex()];
+   const auto expression = static_cast<Token>(code);
+   for (Offset i = 0; i < expression.size(); ++i) {
+      if (expression[i] != '(')
+         continue;
+
+      // Extract the name in front of the bracket, if any               
+      Offset start = i;
+      while (start > 0) {
+         const auto c = expression[start - 1];
+         if (c != '_' and (c < '0' or c > '9') and (c < 'a' or c > 'z') and (c < 'A' or c > 'Z'))
+            break;
+         --start;
+      }
+
+      const auto name = expression.substr(start, i - start);
+      if (name.empty() or IsBuiltIn(name))
+         continue;
+      if (not definitions.FindIt(GLSL {name}))
+         return false;
+   }
+
+   // Copy the definitions, that are referenced by the expression, or   
+   // by any of the copied definitions, in their original order         
+   TMany<GLSL> pending {code};
+   TMany<GLSL> required;
+   while (pending) {
+      const auto user = pending.Last();
+      pending.RemoveIndex(pending.GetCount() - 1);
+
+      for (auto& name : mDefinitionOrder[from.GetStageIndex()]) {
+         if (required.Find(name) or not user.FindKeyword(name))
+            continue;
+
+         required << name;
+         pending << definitions[name];
+      }
+   }
+
+   for (auto& name : mDefinitionOrder[from.GetStageIndex()]) {
+      if (required.Find(name))
+         AddDefine(to, name, definitions[name]);
+   }
+   return true;
+}
+
+/// Hoist an expression out of the pixel stage, into the vertex stage         
+/// Expressions of uniforms yield the same value for every pixel, and are     
+/// passed down as flat varyings. Expressions, that are linear in vertex      
+/// attributes, are safe to interpolate, and are passed as smooth varyings.   
+/// Functions, that the expression calls, are defined in the vertex stage,    
+/// too - expressions calling anything else stay where they are               
+///   @param consumer - the rate at which the expression is used              
+///   @param symbol - the expression to hoist                                 
+///   @return the code to use in place of the expression                      
+GLSL Material::Hoist(RefreshRate consumer, const Symbol& symbol) {
+   // Plain names and function templates are left as they are, there's  
+   // nothing to be gained by moving them                               
+   if (consumer != Rate::Pixel or symbol.mArguments or not symbol.mCode.Find("("))
+      return symbol.mCode;
+
+   // Varyings must be declared with a type                             
+   if (not symbol.mTrait.GetType())
+      return symbol.mCode;
+   const auto rate = symbol.GetInputRate();
+   if (not rate.IsUniform() and rate != Rate::Vertex)
+      return symbol.mCode;
+
+   // Identical expressions share a single varying                      
+   Offset index = 0;
+   while (index < mHoisted.GetCount() and mHoisted[index].mCode != symbol.mCode)
+      ++index;
+   if (index < mHoisted.GetCount())
+      return Text::TemplateRt("inHoisted.m{}", index);
+   if (not Transplant(consumer, Rate::Vertex, symbol.mCode))
+      return symbol.mCode;
+
+   mHoisted << symbol;
+   VERBOSE_NODE("Hoisted `", symbol.mCode, "` from ", consumer,
+      " (inputs at ", rate, ")");
+   return Text::TemplateRt("inHoisted.m{}", index);
 }
 
 /// Generate input name                                                       
@@ -299,6 +594,22 @@ GLSL Material::GenerateOutputName(RefreshRate rate, const Trait& trait) const {
    return {"out", trait.GetTrait()};
 }
 
+/// Write all definitions to the functions of their stage, in the order they  
+/// were added. Must be called before generating inputs and uniforms, which   
+/// are declared only in the stages that use them                             
+void Material::GenerateDefinitions() {
+   for (Offset i = 0; i < ShaderStage::Counter; ++i) {
+      if (not mDefinitionOrder[i])
+         continue;
+
+      GLSL code;
+      for (auto& name : mDefinitionOrder[i])
+         code += mDefinitions[i][name];
+
+      Commit(RefreshRate::StagesBegin + i, ShaderToken::Functions, code);
+   }
+}
+
 /// Generate uniform buffer descriptions for all shader stages                
 void Material::GenerateUniforms() {
    // Scan all uniform rates:                                           
@@ -418,8 +729,6 @@ void Material::GenerateInputs() {
       const auto& inputs = GetInputs(rate);
       Offset location = 0;
 
-      //TODO make sure that correct amount of locations are used,
-      //it depends on the value size: 1 location <= 4 floats
       for (auto& input : inputs) {
          auto vkt = Node::DecayToGLSLType(input.GetType());
          if (not vkt) {
@@ -435,18 +744,23 @@ void Material::GenerateInputs() {
          //    @param {0} - attribute location index                    
          //    @param {1} - type of the vertex attribute                
          //    @param {2} - name of the vertex attribute                
+         //    @param {3} - interpolation qualifier                     
          constexpr auto layout = R"shader(
             layout(location = {0})
-            in {1} {2};
+            {3}in {1} {2};
          )shader";
 
+         // Integer varyings can't be interpolated                      
          const GLSL type {vkt};
          const GLSL name {GenerateInputName(rate, input)};
-         const auto definition = Text::TemplateRt(layout, location, type, name);
+         const Token qualifier = rate == Rate::Pixel and IsInteger(vkt)
+            ? "flat " : "";
+         const auto definition = Text::TemplateRt(layout,
+            location, type, name, qualifier);
 
          // Add input to code                                           
          Commit(rate, ShaderToken::Input, definition);
-         ++location;
+         location += GetLocationCount(vkt);
       }
    }
 }
@@ -458,8 +772,6 @@ void Material::GenerateOutputs() {
       const auto& outputs = GetOutputs(rate);
       Offset location = 0;
 
-      //TODO make sure that correct amount of locations are used,
-      //it depends on the value size: 1 location <= 4 floats
       for (auto& output : outputs) {
          auto vkt = Node::DecayToGLSLType(output.GetType());
          if (not vkt) {
@@ -475,22 +787,102 @@ void Material::GenerateOutputs() {
          //    @param {0} - attribute location index                    
          //    @param {1} - type of the vertex attribute                
          //    @param {2} - name of the vertex attribute                
+         //    @param {3} - interpolation qualifier                     
          constexpr auto layout = R"shader(
             layout(location = {0})
-            out {1} {2};
+            {3}out {1} {2};
          )shader";
 
+         // Integer varyings can't be interpolated                      
          const GLSL type {vkt};
          const GLSL name {GenerateOutputName(rate, output)};
-         const auto definition = Text::TemplateRt(layout, location, type, name);
+         const Token qualifier = rate == Rate::Vertex and IsInteger(vkt)
+            ? "flat " : "";
+         const auto definition = Text::TemplateRt(layout,
+            location, type, name, qualifier);
 
          // Add output to code                                          
          Commit(rate, ShaderToken::Output, definition);
-         ++location;
+         location += GetLocationCount(vkt);
       }
    }
 }
 
+/// Generate the interface block for hoisted expressions                      
+/// Both stages must declare the block at the same location, so it is placed  
+/// after the varyings of whichever stage has more of them. Must be called    
+/// before GenerateInputs, because it might add vertex attributes             
+void Material::GenerateHoisted() {
+   if (not mHoisted)
+      return;
+
+   // Per-vertex expressions refer to the inputs of the pixel stage.    
+   // In the vertex stage, these are the outputs, that the vertex stage 
+   // writes, such as ones computed by vertex pulling. Only inputs that 
+   // nothing writes are passed through from vertex attributes          
+   TMany<GLSL> expressions;
+   for (auto& symbol : mHoisted)
+      expressions << symbol.mCode;
+
+   for (auto& input : GetInputs(Rate::Pixel)) {
+      const auto name = GenerateInputName(Rate::Pixel, input);
+      const bool written {GetOutputs(Rate::Vertex).Find(input)};
+      for (Offset i = 0; i < mHoisted.GetCount(); ++i) {
+         if (mHoisted[i].GetInputRate() != Rate::Vertex
+         or not expressions[i].FindKeyword(name))
+            continue;
+
+         if (written) {
+            expressions[i] = ReplaceKeyword(expressions[i], name,
+               GenerateOutputName(Rate::Vertex, input));
+         }
+         else AddInput(Rate::Vertex, input, false);
+      }
+   }
+
+   // Format the interface block                                        
+   //    @param {0} - location of the block                             
+   //    @param {1} - in/out qualifier                                  
+   //    @param {2} - the list of flat members                          
+   constexpr auto layout = R"shader(
+      layout(location = {0})
+      {1} HoistedBlock {{
+         {2}
+      }} {1}Hoisted;
+   )shader";
+
+   // Integers can't be interpolated, so they are always flat           
+   GLSL members;
+   GLSL assignments;
+   for (Offset i = 0; i < mHoisted.GetCount(); ++i) {
+      const auto& symbol = mHoisted[i];
+      const auto decayed = Node::DecayToGLSLType(symbol.mTrait.GetType());
+      const bool flat = symbol.GetInputRate().IsUniform() or IsInteger(decayed);
+      members += Text::TemplateRt("{}{} m{};\n",
+         flat ? "flat " : "", GLSL {decayed}, i);
+      assignments += Text::TemplateRt("outHoisted.m{} = {};\n", i, expressions[i]);
+   }
+
+   // The block goes after the varyings of either stage, counting the   
+   // locations each of them occupies                                   
+   auto locations = [](const auto& variables) {
+      Count count = 0;
+      for (auto& variable : variables)
+         count += GetLocationCount(Node::DecayToGLSLType(variable.GetType()));
+      return count;
+   };
+
+   const auto location = ::std::max(
+      locations(GetOutputs(Rate::Vertex)),
+      locations(GetInputs(Rate::Pixel))
+   );
+   Commit(Rate::Vertex, ShaderToken::Output,
+      Text::TemplateRt(layout, location, "out", members));
+   Commit(Rate::Vertex, ShaderToken::Transform, assignments);
+   Commit(Rate::Pixel, ShaderToken::Input,
+      Text::TemplateRt(layout, location, "in", members));
+}
+
 /// Initialize the material by using a shadertoy snippet                      
 ///   @param code - the code to port                                          
 void Material::InitializeFromShadertoy(const GLSL& code) {
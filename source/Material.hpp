@@ -9,6 +9,68 @@
 #include "nodes/Root.hpp"
 
 
+///                                                                           
+///   Storage buffer or image, shared between the stages of a material        
+///                                                                           
+/// Storage always uses layout set #3, with bindings in order of addition.    
+/// Sizes might depend on the resolution, in which case they are given per    
+/// screen tile. Storage can also carry contents, that the renderer uploads   
+/// at the given rate, instead of them being computed on the GPU              
+///                                                                           
+struct StorageBinding {
+   // Name of the buffer or image in shader code                        
+   Text mName;
+   // Texel format of an image, or nullptr for buffers                  
+   DMeta mFormat;
+   // Size of a buffer in bytes, that doesn't depend on resolution      
+   Size mBytes {};
+   // Size of a screen tile in pixels, zero if resolution-independent   
+   Count mTile {};
+   // Buffer bytes per screen tile - images get a texel per tile        
+   Size mBytesPerTile {};
+   // Whether the renderer clears the storage to zero each frame        
+   bool mClear {};
+   // Contents to upload, shared with the node that provides them       
+   Many mContents;
+   // The rate at which the contents are uploaded                       
+   RefreshRate mRate = Rate::Auto;
+};
+
+///                                                                           
+///   Compute stage dispatch                                                  
+///                                                                           
+/// Work groups either have a fixed count, or cover the whole screen, with    
+/// each invocation covering a tile of pixels                                 
+///                                                                           
+struct ComputeDispatch {
+   // Fixed number of work groups                                       
+   Vec3u mGroups;
+   // Size of a screen tile in pixels, zero if resolution-independent   
+   Count mTile {};
+   // Work group size, for dispatches that cover the screen             
+   Vec2u mLocal;
+
+   bool operator == (const ComputeDispatch&) const = default;
+};
+
+///                                                                           
+///   Sampler of a shared texture atlas page                                  
+///                                                                           
+/// The page is an index into the atlas of the MaterialLibrary, which holds   
+/// the images and regions, that the page texture is composed of. The page    
+/// texture must have no more mip levels than given, because the padding      
+/// between images doesn't keep them apart in any smaller levels              
+///                                                                           
+struct AtlasSampler {
+   // Name of the sampler in shader code                                
+   GLSL mSampler;
+   // Index of the atlas page                                           
+   Offset mPage {};
+   // Number of mip levels of the page texture                          
+   Count mMipCount {};
+};
+
+
 ///                                                                           
 ///   A material generator                                                    
 ///                                                                           
@@ -27,8 +89,17 @@ private:
    // Compiled flow                                                     
    Temporal mCompiled;
 
-   // Defined symbols for each shader stage                             
-   TUnorderedMap<GLSL, TMany<GLSL>> mDefinitions[ShaderStage::Counter];
+   // Defined symbols for each shader stage, by name, and the order in  
+   // which they were added, so that each follows its dependencies      
+   TUnorderedMap<GLSL, GLSL> mDefinitions[ShaderStage::Counter];
+   TMany<GLSL> mDefinitionOrder[ShaderStage::Counter];
+
+   // Expressions of uniforms, hoisted out of the pixel stage           
+   // They are computed per vertex, and passed down as flat varyings    
+   Symbols mHoisted;
+
+   // Samplers of the shared atlas pages, that this material uses       
+   TUnorderedMap<Offset, GLSL> mAtlasSamplers;
 
    // Root node                                                         
    // It is of utmost importance this node is the last member, because  
@@ -47,7 +118,7 @@ public:
    ~Material();
 
    void Create(Verb&);
-   void Refresh() {}
+   void Refresh();
    bool Generate(TMeta, Offset = 0);
 
    auto GetLOD(const LOD&) const -> Ref<A::Material>;
@@ -65,12 +136,23 @@ public:
    GLSL AddInput (RefreshRate, const Trait&, bool allowDuplicates);
    GLSL AddOutput(RefreshRate, const Trait&, bool allowDuplicates);
    void AddDefine(RefreshRate, const Token&, const GLSL&);
+   GLSL Hoist    (RefreshRate, const Symbol&);
+   bool Transplant(RefreshRate, RefreshRate, const GLSL&);
+   GLSL AddAtlas (Offset page, Count mips);
+   void SetDraw  (Count vertices, Count instances);
+   void SetDispatch(const ComputeDispatch&);
+   auto AddStorage (const StorageBinding&, bool allowDuplicates) -> Offset;
 
 private:
+   template<CT::Trait>
+   auto& GetExposed();
+
    GLSL GenerateInputName (RefreshRate, const Trait&) const;
    GLSL GenerateOutputName(RefreshRate, const Trait&) const;
+   void GenerateDefinitions();
    void GenerateUniforms();
    void GenerateInputs();
    void GenerateOutputs();
+   void GenerateHoisted();
    void InitializeFromShadertoy(const GLSL&);
 };
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include "nodes/Raytrace.hpp"
 #include "nodes/Scene.hpp"
 #include "nodes/Texture.hpp"
+#include "nodes/Transform.hpp"
 #include "nodes/Value.hpp"
 
 #include <Langulus/Math/Normal.hpp>
@@ -27,6 +28,10 @@ LANGULUS_DEFINE_MODULE(
    MaterialLibrary, 9, "AssetsMaterials",
    "Module for reading, writing, and generating GLSL/HLSL shaders for visualizing materials", "",
    MaterialLibrary, Material, GLSL,
+   Traits::Compressed, Traits::Repeat, Traits::Variation, Traits::Setup,
+   Traits::Tile, Traits::Thickness, Traits::Strategy, Traits::Downsample,
+   Traits::ProjectedView, Traits::Unroll, Traits::Derivative, Traits::Draw,
+   Traits::Storage, Traits::Dispatch, Traits::Atlas,
    Nodes::Camera,
    Nodes::FBM,
    Nodes::Light,
@@ -36,6 +41,7 @@ LANGULUS_DEFINE_MODULE(
    Nodes::Root,
    Nodes::Scene,
    Nodes::Texture,
+   Nodes::Transform,
    Nodes::Value
 )
 
@@ -58,10 +64,17 @@ MaterialLibrary::MaterialLibrary(Runtime* runtime, const Many&)
 /// First stage destruction                                                   
 void MaterialLibrary::Teardown() {
    mMaterials.Teardown();
+   mAtlas.Reset();
 }
 
 /// Create/Destroy materials                                                  
 ///   @param verb - the creation/destruction verb                             
 void MaterialLibrary::Create(Verb& verb) {
    mMaterials.Create(this, verb);
+}
+
+/// Get the texture atlas, shared by all materials                            
+///   @return the atlas                                                       
+auto MaterialLibrary::GetAtlas() noexcept -> Atlas& {
+   return mAtlas;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 ///                                                                           
 #pragma once
 #include "Material.hpp"
+#include "Atlas.hpp"
 #include <Langulus/Flow/Factory.hpp>
 #include <Langulus/Verbs/Create.hpp>
 
@@ -26,6 +27,8 @@ private:
    TFactoryUnique<::Material> mMaterials;
    // Data folder, where materials will be saved or loaded from         
    Ref<A::Folder> mFolder;
+   // Small textures of all materials, packed together                  
+   Atlas mAtlas;
 
 public:
    MaterialLibrary(Runtime*, const Many&);
@@ -34,5 +37,7 @@ public:
 
    void Create(Verb&);
    void Teardown();
+
+   auto GetAtlas() noexcept -> Atlas&;
 };
 
@@ -177,13 +177,31 @@ void Node::Select(Verb& verb) {
       verb << found;
 }
 
+/// Get the rate of an expression, from the rates of its two operands         
+/// The expression is as frequent as its most frequent operand. Constants     
+/// have no rate, and don't raise it. Per-vertex operands stay per-vertex     
+/// only through operations that are safe to interpolate                      
+///   @param a - rate of the first operand                                    
+///   @param b - rate of the second operand                                   
+///   @param linear - whether the operation is linear in per-vertex operands  
+///   @return the rate of the expression                                      
+auto Node::CombineRates(RefreshRate a, RefreshRate b, bool linear) const -> RefreshRate {
+   auto rate = a;
+   if (b != Rate::Auto and (rate == Rate::Auto or rate <= b))
+      rate = b;
+   if (not linear and rate == Rate::Vertex)
+      rate = GetRate();
+   return rate;
+}
+
 /// An arithmetic verb implementation                                         
 /// Uses a pattern to modify all output symbols                               
 ///   @param verb - the verb to satisfy                                       
+///   @param linearity - how the operation behaves under interpolation        
 ///   @param pos - the positive pattern                                       
 ///   @param neg - the negative pattern (optional)                            
 ///   @param unary - the unary pattern (optional)                             
-void Node::ArithmeticVerb(Verb& verb, const Token& pos, const Token& neg, const Token& unary) {
+void Node::ArithmeticVerb(Verb& verb, Linearity linearity, const Token& pos, const Token& neg, const Token& unary) {
    if (verb.GetMass() == 0)
       return;
 
@@ -191,8 +209,12 @@ void Node::ArithmeticVerb(Verb& verb, const Token& pos, const Token& neg, const
    bool success {};
    if (not verb and inverse and unary.size()) {
       // No argument, so an unary minus sign                            
-      ForEachOutput([&success,&unary](Symbol& symbol) {
-         symbol.mCode = Text::TemplateRt(unary, symbol.mCode);
+      // Only negation is safe to interpolate, reciprocals aren't       
+      ForEachOutput([&](Symbol& symbol) {
+         const auto rate = CombineRates(symbol.GetInputRate(), Rate::Auto,
+            linearity == Linearity::Additive);
+         symbol.mCode = Text::TemplateRt(unary, mMaterial->Hoist(rate, symbol));
+         symbol.mInputRate = rate;
          success = true;
       });
 
@@ -211,18 +233,37 @@ void Node::ArithmeticVerb(Verb& verb, const Token& pos, const Token& neg, const
             if (not code)
                return;
 
-            if (neg.empty() or not inverse) {
-               ForEachOutput([&](Symbol& symbol) {
-                  symbol.mCode = Text::TemplateRt(pos, symbol.mCode, code);
-                  success = true;
-               });
-            }
-            else {
-               ForEachOutput([&](Symbol& symbol) {
-                  symbol.mCode = Text::TemplateRt(neg, symbol.mCode, code);
-                  success = true;
-               });
-            }
+            // Selected symbols carry the rate of their inputs, while   
+            // anything else is a constant, and doesn't raise the rate  
+            Symbol operand;
+            operand.mCode = code;
+            if (element.template Is<Symbol*>())
+               operand.mInputRate = element.template As<Symbol*>()->GetInputRate();
+
+            const auto& pattern = neg.empty() or not inverse ? pos : neg;
+            ForEachOutput([&](Symbol& symbol) {
+               // Products are linear, as long as one of the operands   
+               // doesn't vary per vertex - divisors never may          
+               bool linear = linearity == Linearity::Additive;
+               if (linearity == Linearity::Multiplicative) {
+                  linear = operand.mInputRate != Rate::Vertex
+                     or (not inverse and symbol.GetInputRate() != Rate::Vertex);
+               }
+
+               // Any uniform or per-vertex subexpression is hoisted    
+               // out of the pixel stage, as soon as it meets an input  
+               // of a higher rate, or an operation that isn't linear   
+               // The symbol stays selectable at its own rate, only the 
+               // rate of its inputs is recorded                        
+               const auto rate = CombineRates(symbol.GetInputRate(),
+                  operand.mInputRate, linear);
+
+               symbol.mCode = Text::TemplateRt(pattern,
+                  mMaterial->Hoist(rate, symbol),
+                  mMaterial->Hoist(rate, operand));
+               symbol.mInputRate = rate;
+               success = true;
+            });
          }
          catch (...) { }
       });
@@ -236,25 +277,25 @@ void Node::ArithmeticVerb(Verb& verb, const Token& pos, const Token& neg, const
 /// Add/subtract inputs                                                       
 ///   @param verb - the addition/subtraction verb                             
 void Node::Add(Verb& verb) {
-   ArithmeticVerb(verb, "({} + {})", "({} - {})", "-{}");
+   ArithmeticVerb(verb, Linearity::Additive, "({} + {})", "({} - {})", "-{}");
 }
 
 /// Multiply/divide inputs                                                    
 ///   @param verb - the multiplication verb                                   
 void Node::Multiply(Verb& verb) {
-   ArithmeticVerb(verb, "({} * {})", "({} / {})", "1.0 / {}");
+   ArithmeticVerb(verb, Linearity::Multiplicative, "({} * {})", "({} / {})", "1.0 / {}");
 }
 
 /// Modulate inputs                                                           
 ///   @param verb - the modulation verb                                       
 void Node::Modulate(Verb& verb) {
-   ArithmeticVerb(verb, "mod({}, {})");
+   ArithmeticVerb(verb, Linearity::None, "mod({}, {})");
 }
 
 /// Exponentiate inputs                                                       
 ///   @param verb - the exponentiation verb                                   
 void Node::Exponent(Verb& verb) {
-   ArithmeticVerb(verb, "pow({}, {})");
+   ArithmeticVerb(verb, Linearity::None, "pow({}, {})");
 }
 
 /// Randomize inputs                                                          
@@ -287,7 +328,10 @@ void Node::Randomize(Verb& verb) {
          else
             TODO();
 
-         symbol.mCode = Text::TemplateRt("SimplexNoise1({})", symbol.mCode);
+         const auto rate = CombineRates(symbol.GetInputRate(), Rate::Auto, false);
+         symbol.mCode = Text::TemplateRt("SimplexNoise1({})",
+            mMaterial->Hoist(rate, symbol));
+         symbol.mInputRate = rate;
          success = true;
       }
       else TODO();
@@ -457,10 +501,10 @@ GLSL ConvertSymbol(const Trait& trait, const GLSL& symbol, DMeta as, Real filler
    return {};
 }
 
-/// Get a default type of each of the standard traits                         
+/// Find the default type of a standard trait                                 
 ///   @param trait - the trait definition                                     
-///   @return the default trait properties                                    
-Node::DefaultTrait Node::GetDefaultTrait(TMeta trait) {
+///   @return the default trait properties, or nullptr if not standard        
+auto Node::FindDefaultTrait(TMeta trait) -> const DefaultTrait* {
    static TUnorderedMap<TMeta, DefaultTrait> properties;
 
    if (not properties) {
@@ -478,6 +522,8 @@ Node::DefaultTrait Node::GetDefaultTrait(TMeta trait) {
          DefaultTrait {MetaOf<Mat4>(), Rate::Camera});
       properties.Insert(MetaOf<Traits::FOV>(),
          DefaultTrait {MetaOf<Real>(), Rate::Camera});
+      properties.Insert(MetaOf<Traits::ProjectedView>(),
+         DefaultTrait {MetaOf<Mat4>(), Rate::Camera});
 
       properties.Insert(MetaOf<Traits::View>(),
          DefaultTrait {MetaOf<Mat4>(), Rate::Level});
@@ -500,7 +546,17 @@ Node::DefaultTrait Node::GetDefaultTrait(TMeta trait) {
 
    auto found = properties.Find(trait);
    if (found)
-      return properties.GetValue(found);
+      return &properties.GetValue(found);
+   return nullptr;
+}
+
+/// Get a default type of each of the standard traits                         
+///   @param trait - the trait definition                                     
+///   @return the default trait properties                                    
+Node::DefaultTrait Node::GetDefaultTrait(TMeta trait) {
+   const auto properties = FindDefaultTrait(trait);
+   if (properties)
+      return *properties;
 
    LANGULUS_OOPS(Material, "Undefined default trait: ", trait);
    return {};
@@ -510,7 +566,16 @@ Node::DefaultTrait Node::GetDefaultTrait(TMeta trait) {
 ///   @param meta - the type to decay                                         
 ///   @return the decayed type                                                
 DMeta Node::DecayToGLSLType(DMeta meta) {
-   if (meta->template CastsTo<Double>(4))
+   if (meta->template CastsTo<Double>(16))
+      return MetaOf<Mat4d>();
+   else if (meta->template CastsTo<Double>(9))
+      return MetaOf<Mat3d>();
+   else if (meta->template CastsTo<Float>(16))
+      return MetaOf<Mat4f>();
+   else if (meta->template CastsTo<Float>(9))
+      return MetaOf<Mat3f>();
+
+   else if (meta->template CastsTo<Double>(4))
       return MetaOf<Vec4d>();
    else if (meta->template CastsTo<Double>(3))
       return MetaOf<Vec3d>();
@@ -519,6 +584,24 @@ DMeta Node::DecayToGLSLType(DMeta meta) {
    else if (meta->template CastsTo<Double>(1))
       return MetaOf<Double>();
 
+   // Integers stay integers, because they can't be interpolated        
+   else if (meta->template CastsTo<int32_t>(4))
+      return MetaOf<Vec4i>();
+   else if (meta->template CastsTo<int32_t>(3))
+      return MetaOf<Vec3i>();
+   else if (meta->template CastsTo<int32_t>(2))
+      return MetaOf<Vec2i>();
+   else if (meta->template CastsTo<int32_t>(1))
+      return MetaOf<int32_t>();
+   else if (meta->template CastsTo<uint32_t>(4))
+      return MetaOf<Vec4u>();
+   else if (meta->template CastsTo<uint32_t>(3))
+      return MetaOf<Vec3u>();
+   else if (meta->template CastsTo<uint32_t>(2))
+      return MetaOf<Vec2u>();
+   else if (meta->template CastsTo<uint32_t>(1))
+      return MetaOf<uint32_t>();
+
    else if (meta->template CastsTo<Float>(4) or meta->template CastsTo<A::Number>(4))
       return MetaOf<Vec4f>();
    else if (meta->template CastsTo<Float>(3) or meta->template CastsTo<A::Number>(3))
@@ -600,6 +683,34 @@ auto Node::GetSymbol(TMeta t, DMeta d, RefreshRate r, Index i) -> Symbol* {
       TODO();
    }
 
-   // Nothing was found                                                 
-   return nullptr;
+   // Climb up the hierarchy                                            
+   if (mParent)
+      return mParent->GetSymbol(t, d, r, i);
+
+   // Nothing was found in the hierarchy, so select a global material   
+   // input, if the trait is a standard one                             
+   return t ? GetInputSymbol(t, d) : nullptr;
+}
+
+/// Select a standard trait as a material input, declaring the input if it    
+/// isn't declared yet. The input is kept as a local symbol, so that          
+/// subsequent selections find it                                             
+/// Only uniforms are selectable this way - varyings are provided by the      
+/// nodes, that generate them                                                 
+///   @param t - trait type filter                                            
+///   @param d - data type filter                                             
+///   @return a pointer to the symbol, or nullptr if trait isn't available    
+auto Node::GetInputSymbol(TMeta t, DMeta d) -> Symbol* {
+   const auto properties = FindDefaultTrait(t);
+   if (not properties or not properties->mRate.IsUniform())
+      return nullptr;
+   if (d and not properties->mType->CastsTo(d))
+      return nullptr;
+
+   Symbol symbol;
+   symbol.mRate = properties->mRate;
+   symbol.mTrait = Trait::FromMeta(t, properties->mType);
+   symbol.mCode = mMaterial->AddInput(properties->mRate, symbol.mTrait, false);
+   mLocalsT[t] << Abandon(symbol);
+   return &mLocalsT[t].Last();
 }
\ No newline at end of file
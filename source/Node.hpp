@@ -56,6 +56,16 @@ protected:
       RefreshRate mRate;
    };
 
+   // How an arithmetic operation behaves under interpolation           
+   enum class Linearity {
+      // Interpolating the operands interpolates the result             
+      Additive,
+      // Linear only while one of the operands doesn't vary per vertex  
+      Multiplicative,
+      // Has to be computed for each pixel separately                   
+      None
+   };
+
    static inline const Symbol NoSymbol {};
 
 public:
@@ -94,6 +104,7 @@ public:
    auto GetStage() const -> Offset;
    auto GetMaterial() const noexcept -> Material*;
    auto GetLibrary() const noexcept -> MaterialLibrary*;
+   static auto FindDefaultTrait(TMeta) -> const DefaultTrait*;
    static auto GetDefaultTrait(TMeta) -> DefaultTrait;
    static auto DecayToGLSLType(DMeta) -> DMeta;
 
@@ -133,6 +144,8 @@ protected:
    template<CT::Trait T, CT::Data D>
    auto AddLiteral(D&&) -> const Symbol&;
 
+   auto GetInputSymbol(TMeta, DMeta) -> Symbol*;
+
    template<CT::Data T, class... ARGS>
    auto ExposeData(const Token&, ARGS&&...) -> Symbol&;
 
@@ -141,7 +154,8 @@ protected:
 
    void AddDefine(const Token&, const GLSL&);
 
-   void ArithmeticVerb(Verb&, const Token& pos, const Token& neg = {}, const Token& una = {});
+   auto CombineRates(RefreshRate, RefreshRate, bool linear) const -> RefreshRate;
+   void ArithmeticVerb(Verb&, Linearity, const Token& pos, const Token& neg = {}, const Token& una = {});
 };
 
 #include "Node.inl"
@@ -0,0 +1,80 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Packing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+/// Quantize a number in the [0; 1] range to 16 bits                          
+///   @param value - the value to quantize                                    
+///   @return the quantized value                                             
+auto PackUnorm16(Real value) noexcept -> uint32_t {
+   const auto clamped = ::std::min(::std::max(value, Real {0}), Real {1});
+   return static_cast<uint32_t>(clamped * 65535 + Real {0.5});
+}
+
+/// Convert a number to a half-precision float, same as GLSL's packHalf2x16   
+///   @param value - the value to convert                                     
+///   @return the 16-bit half float                                           
+auto PackHalf(Real value) noexcept -> uint32_t {
+   const auto single = static_cast<float>(value);
+   uint32_t bits;
+   ::std::memcpy(&bits, &single, sizeof(bits));
+
+   const uint32_t sign = (bits >> 16) & 0x8000u;
+   const uint32_t exponent = (bits >> 23) & 0xFFu;
+   uint32_t mantissa = bits & 0x7FFFFFu;
+   if (exponent == 0xFFu)
+      return sign | 0x7C00u | (mantissa ? 0x200u : 0u);  // inf/nan
+
+   const int rebiased = static_cast<int>(exponent) - 127 + 15;
+   if (rebiased >= 31)
+      return sign | 0x7C00u;                             // overflow
+
+   if (rebiased <= 0) {
+      // Denormalized half, or zero                                     
+      if (rebiased < -10)
+         return sign;
+
+      mantissa |= 0x800000u;
+      const auto shift = static_cast<uint32_t>(14 - rebiased);
+      uint32_t half = mantissa >> shift;
+      if ((mantissa >> (shift - 1)) & 1u)
+         ++half;
+      return sign | half;
+   }
+
+   // Rounding might carry into the exponent, which is correct          
+   uint32_t half = sign | (static_cast<uint32_t>(rebiased) << 10) | (mantissa >> 13);
+   if (mantissa & 0x1000u)
+      ++half;
+   return half;
+}
+
+/// Encode a normal in two 16-bit snorms, using octahedral mapping            
+///   @param normal - the normal to encode                                    
+///   @return the encoded normal, same layout as GLSL's packSnorm2x16         
+auto PackOctahedral(const Vec3& normal) noexcept -> uint32_t {
+   const auto sum = ::std::abs(normal[0]) + ::std::abs(normal[1]) + ::std::abs(normal[2]);
+   Real x = sum > 0 ? normal[0] / sum : 0;
+   Real y = sum > 0 ? normal[1] / sum : 0;
+   if (normal[2] < 0) {
+      const auto ox = x;
+      x = (Real {1} - ::std::abs(y))  * (ox >= 0 ? 1 : -1);
+      y = (Real {1} - ::std::abs(ox)) * (y  >= 0 ? 1 : -1);
+   }
+
+   const auto snorm = [](Real v) -> uint32_t {
+      const auto clamped = ::std::min(::std::max(v, Real {-1}), Real {1});
+      const auto fixed = static_cast<int32_t>(::std::round(clamped * 32767));
+      return static_cast<uint32_t>(fixed) & 0xFFFFu;
+   };
+
+   return snorm(x) | (snorm(y) << 16);
+}
@@ -0,0 +1,20 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Common.hpp"
+
+
+///                                                                           
+///   Quantization helpers                                                    
+///                                                                           
+/// Encode numbers in the same bit layouts, that GLSL's unpack functions      
+/// expect, so that data can be baked into shaders in a compact form          
+///                                                                           
+auto PackUnorm16(Real) noexcept -> uint32_t;
+auto PackHalf(Real) noexcept -> uint32_t;
+auto PackOctahedral(const Vec3&) noexcept -> uint32_t;
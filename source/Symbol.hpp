@@ -20,6 +20,12 @@ struct Symbol {
    // The rate at which this symbol is recomputed                       
    RefreshRate mRate = Rate::Auto;
 
+   // The rate at which the inputs of the expression change, if lower   
+   // than the symbol's rate. Expressions of less frequent inputs can   
+   // be hoisted out of the stage they're consumed in. Auto if the      
+   // inputs change as frequently as the symbol                         
+   RefreshRate mInputRate = Rate::Auto;
+
    // The trait (if any), the data type (if any), and the value (if     
    // the symbol is a constant/literal). If this symbol represents a    
    // function call, then this is its return type                       
@@ -52,6 +58,7 @@ public:
    template<CT::Intent S> requires CT::Exact<TypeOf<S>, Symbol>
    Symbol(S&& other)
       : mRate {other->mRate}
+      , mInputRate {other->mInputRate}
       , mTrait {S::Nest(other->mTrait)}
       , mCode {S::Nest(other->mCode)}
       , mCount {other->mCount}
@@ -67,6 +74,7 @@ public:
    static Symbol Variable(RefreshRate, D&&, const Token&);
 
    bool MatchesFilter(DMeta, RefreshRate) const noexcept;
+   auto GetInputRate() const noexcept -> RefreshRate;
 
    GLSL Generate(const Node*) const;
 
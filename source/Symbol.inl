@@ -74,6 +74,13 @@ bool Symbol::MatchesFilter(DMeta d, RefreshRate r) const noexcept {
    return (!d || mTrait.CastsToMeta(d)) && (r == Rate::Auto || r <= mRate);
 }
 
+/// Get the rate at which the inputs of the expression change                 
+///   @return the input rate, or the symbol's rate if not lower               
+LANGULUS(INLINED)
+auto Symbol::GetInputRate() const noexcept -> RefreshRate {
+   return mInputRate == Rate::Auto ? mRate : mInputRate;
+}
+
 LANGULUS(INLINED)
 void Symbol::PushArgument(DMeta&& type) {
    mArguments << Trait::FromMeta(nullptr, type);
@@ -6,6 +6,7 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #include "Camera.hpp"
+#include "../Material.hpp"
 #include <Langulus/Graphics.hpp>
 #include <Langulus/Math/Matrix.hpp>
 
@@ -18,6 +19,43 @@ Camera::Camera(Describe descriptor)
    : Resolvable {this}
    , Node       {*descriptor} { }
 
+/// Check if the camera has a view transformation in its descriptor           
+/// Otherwise, it is the default 2D screen projection                         
+///   @return true if the camera is explicit                                  
+bool Camera::IsExplicit() {
+   bool explicitCamera = false;
+   mDescriptor.ForEachDeep([&](const Traits::View&) {
+      explicitCamera = true;
+   });
+   return explicitCamera;
+}
+
+/// Get the projected view transformation of a camera                         
+/// Explicit cameras get it as a Camera-rate uniform. The default screen      
+/// projection depends only on the resolution, so it is hoisted out of the    
+/// pixel stage, instead of being built for each pixel                        
+///   @param user - the node that uses the projection                         
+///   @param camera - the camera, or nullptr for the default one              
+///   @param consumer - the rate at which the projection is used              
+///   @return the GLSL code for the projected view (mat4)                     
+GLSL Camera::GetProjectedView(Node& user, Camera* camera, RefreshRate consumer) {
+   const auto material = user.GetMaterial();
+   if (camera and camera->IsExplicit()) {
+      return material->AddInput(Rate::Camera,
+         Traits::ProjectedView::OfType<Mat4>(), false);
+   }
+
+   auto symRes = user.GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material,
+      "No view, or resolution available for camera");
+
+   Symbol projection;
+   projection.mRate = Rate::Camera;
+   projection.mTrait = Traits::ProjectedView::OfType<Mat4>();
+   projection.mCode = Text::TemplateRt(CameraProjectedViewDefault, *symRes);
+   return material->Hoist(consumer, projection);
+}
+
 /// Generate the camera code                                                  
 ///   @return the output symbol                                               
 auto Camera::Generate() -> const Symbol& {
@@ -27,23 +65,22 @@ auto Camera::Generate() -> const Symbol& {
 
    // Check traits in descriptor to figure out what kind of camera we   
    // are creating                                                      
-   bool explicitCamera = false;
-   mDescriptor.ForEachDeep([&](const Traits::View& view) {
-      (void) view;
-
+   if (IsExplicit()) {
       // Projection based on camera view transformation                 
       if (mRate == Rate::Pixel) {
-         auto symView = GetSymbol<Traits::View,       Mat4>(Rate::Level);
-         auto symFov  = GetSymbol<Traits::FOV,        Real>(Rate::Camera);
-         auto symProj = GetSymbol<Traits::Projection, Mat4>(Rate::Level);
-         auto symRes  = GetSymbol<Traits::Size,       Vec2>(Rate::Tick);
+         auto symView = GetSymbol<Traits::View, Mat4>(Rate::Level);
+         auto symFov  = GetSymbol<Traits::FOV,  Real>(Rate::Camera);
+         auto symRes  = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+
+         // The projected view changes only per camera, so it is a      
+         // uniform, instead of a matrix product in every pixel         
+         const auto projectedView = GetProjectedView(*this, this, mRate);
 
          // Combine pixel position with the view matrix to from         
          // the projection per pixel. This allows for optically         
          // realistic rendering (near and far planes are not flat)      
          AddDefine("Camera",
-            Text::TemplateRt(CameraFuncPerPixel, *symRes, *symView, *symFov, *symProj));
-         explicitCamera = true;
+            Text::TemplateRt(CameraFuncPerPixel, *symRes, *symView, *symFov, projectedView));
       }
       else if (mRate == Rate::Vertex) {
          auto symView = GetSymbol<Traits::View,  Mat4>(Rate::Level);
@@ -53,17 +90,16 @@ auto Camera::Generate() -> const Symbol& {
          // the projection per vertex                                   
          AddDefine("Camera",
             Text::TemplateRt(CameraFuncPerVertex, *symView, *symPos));
-         explicitCamera = true;
       }
       else TODO();
-   });
-
-   if (not explicitCamera) {
+   }
+   else {
       // By default it simply projects 2D based on the pixel position   
       Logger::Warning("No explicit camera defined - using default 2D screen projection");
       mRate = Rate::Pixel;
       auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
-      AddDefine("Camera", Text::TemplateRt(CameraFuncDefault, *symRes));
+      AddDefine("Camera", Text::TemplateRt(CameraFuncDefault, *symRes,
+         GetProjectedView(*this, nullptr, mRate)));
    }
 
    // Expose the results to the rest of the nodes                       
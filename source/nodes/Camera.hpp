@@ -21,6 +21,9 @@ namespace Nodes
 
       Camera(Describe);
       auto Generate() -> const Symbol&;
+
+      bool IsExplicit();
+      static GLSL GetProjectedView(Node&, Camera*, RefreshRate);
    };
 
 } // namespace Nodes
@@ -38,10 +41,12 @@ constexpr Token CameraResult = R"shader(
 )shader";
 
 /// PerPixel Camera() shader function                                         
+/// Only the direction depends on the fragment, everything else is either a   
+/// uniform, or a swizzle of one                                              
 ///   @param {0} - resolution symbol (vec2)                                   
 ///   @param {1} - view transformation symbol (mat4)                          
 ///   @param {2} - field of view symbol (horizontal, in radians)              
-///   @param {3} - projection transformation symbol (mat4)                    
+///   @param {3} - projected view transformation symbol (mat4)                
 constexpr Token CameraFuncPerPixel = R"shader(
    CameraResult Camera() {{
       CameraResult result;
@@ -49,7 +54,7 @@ constexpr Token CameraFuncPerPixel = R"shader(
       result.mScreenUV = (result.mFragment * 2.0 - {0}) / {0}.x;
       result.mDirection = ({1} * normalize(vec4(result.mScreenUV, {2}, 0.0))).xyz;
       result.mOrigin = {1}[3].xyz;
-      result.mProjectedView = {1}*{3};
+      result.mProjectedView = {3};
       return result;
    }}
 )shader";
@@ -67,8 +72,53 @@ constexpr Token CameraFuncPerVertex = R"shader(
    }}
 )shader";
 
+/// CameraRay() shader function, same as the PerPixel Camera(), but for an    
+/// arbitrary fragment. Useful in stages, where gl_FragCoord isn't available  
+///   @param {0} - resolution symbol (vec2)                                   
+///   @param {1} - view transformation symbol (mat4)                          
+///   @param {2} - field of view symbol (horizontal, in radians)              
+constexpr Token CameraRayPerPixel = R"shader(
+   CameraResult CameraRay(in vec2 fragCoord) {{
+      CameraResult result;
+      result.mFragment = vec2(fragCoord.x, {0}.y - fragCoord.y);
+      result.mScreenUV = (result.mFragment * 2.0 - {0}) / {0}.x;
+      result.mDirection = ({1} * normalize(vec4(result.mScreenUV, {2}, 0.0))).xyz;
+      result.mOrigin = {1}[3].xyz;
+      return result;
+   }}
+)shader";
+
+/// Default CameraRay() shader function, same as CameraFuncDefault            
+///   @param {0} - resolution symbol (vec2)                                   
+constexpr Token CameraRayDefault = R"shader(
+   CameraResult CameraRay(in vec2 fragCoord) {{
+      CameraResult result;
+      result.mFragment = vec2(fragCoord.x, {0}.y - fragCoord.y);
+      result.mScreenUV = (result.mFragment * 2.0 - {0}) / {0}.x;
+      result.mDirection = vec3(0.0, 0.0, -1.0);
+      result.mOrigin = vec3(result.mScreenUV, 0.0);
+      return result;
+   }}
+)shader";
+
+/// Default 2D screen projection, used by the default Camera() function       
+/// It depends only on the resolution, so it is never built per pixel -       
+/// see Camera::GetProjectedView                                              
+///   @param {0} - resolution symbol (vec2)                                   
+constexpr Token CameraProjectedViewDefault = R"shader(
+   mat4(
+       2.0 / {0}.x,  0.0,              0.0,    0.0,
+       0.0,          2.0 / {0}.x,      0.0,    0.0,
+       0.0,          0.0,              1.0,    0.0,
+      -1.0,          -{0}.y / {0}.x,   1.0,    1.0
+   )
+)shader";
+
 /// Default Camera() shader function (PerPixel)                               
+/// Without an explicit camera there's nothing for the renderer to provide,   
+/// so the 2D screen projection is built from the resolution alone            
 ///   @param {0} - resolution symbol (vec2)                                   
+///   @param {1} - projected view transformation (mat4)                       
 constexpr Token CameraFuncDefault = R"shader(
    CameraResult Camera() {{
       CameraResult result;
@@ -76,13 +126,7 @@ constexpr Token CameraFuncDefault = R"shader(
       result.mScreenUV = (result.mFragment * 2.0 - {0}) / {0}.x;
       result.mDirection = vec3(0.0, 0.0, -1.0);
       result.mOrigin = vec3(result.mScreenUV, 0.0);
-      const float uniformScale = 2.0 / {0}.x;
-      result.mProjectedView = mat4(
-          uniformScale, 0.0,              0.0,    0.0,
-          0.0,          uniformScale,     0.0,    0.0,
-          0.0,          0.0,              1.0,    0.0,
-         -1.0,          -{0}.y / {0}.x,   1.0,    1.0
-      );
+      result.mProjectedView = {1};
       return result;
    }}
 )shader";
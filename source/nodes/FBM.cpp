@@ -8,6 +8,8 @@
 #include "FBM.hpp"
 #include "Value.hpp"
 #include "../Material.hpp"
+#include "../Baker.hpp"
+#include <Langulus/Image.hpp>
 
 using namespace Nodes;
 
@@ -27,6 +29,12 @@ FBM::FBM(Describe&& descriptor)
    LANGULUS_ASSERT(mBaseWeight != 0, Material,
       "Base weight is zero", mOctaveCount);
 
+   // Extract the number of octaves, that are unrolled at most          
+   mDescriptor.ExtractTrait<Traits::Unroll>(mUnroll);
+
+   // Extract the size of the baked texture, if any                     
+   mDescriptor.ExtractTrait<Traits::Size>(mBakeSize);
+
    // Extract octave code                                               
    // That code also contains all required variables in the form of     
    // selection verbs                                                   
@@ -34,6 +42,12 @@ FBM::FBM(Describe&& descriptor)
    //LANGULUS_ASSERT(mCode, Material, "No FBM octave code"); //TODO
 }
 
+/// Release all external resources to avoid circular dependencies             
+void FBM::Detach() {
+   mBaked.Reset();
+   Node::Detach();
+}
+
 /// For logging                                                               
 FBM::operator Text() const {
    Code result;
@@ -49,25 +63,43 @@ const Symbol& FBM::Generate() {
    // Generate children first                                           
    Descend();
 
-   // Generate octaves                                                  
+   // Compile the octave code only once, in a temporary node - we don't 
+   // want any persistent side effects from executing the code here.    
+   // The octave index and mass are parameters, instead of literals, so 
+   // the same code serves all octaves                                  
+   Nodes::Value temporary {this};
+   temporary.template AddLocal<Traits::Index>(int {}, "octave");
+   temporary.template AddLocal<Traits::Mass>(Real {}, "mass");
+   const auto& uv = temporary.template AddLocal<Traits::Place>(Vec2 {}, "uv");
+   temporary.Run(mCode);
+
+   auto& symbol = temporary.Generate();
+   if (Bake(symbol, uv))
+      return ExposeData<Real>("FBM({})", Traits::Place::OfType<Vec2>());
+
+   // The octave code refers to the function's own parameters, so it    
+   // can't be hoisted out of it                                        
+   AddDefine("FBMOctave",
+      Text::TemplateRt(FBMOctaveFunction, "", symbol.mCode));
+
+   // Instantiate the octaves - unrolled, or in a loop that reads its   
+   // weights from a constant array, when there are too many of them    
    Real f {mBaseWeight};
    GLSL octaves;
-   for (Offset i = 0; i < mOctaveCount && mBaseWeight != 0; ++i) {
-      // Make a temporary node for each octave, we don't want any       
-      // persistent side effects from executing the code here           
-      Nodes::Value temporary {this};
-
-      // Update inputs for each octave, octave code might use them      
-      temporary.template AddLiteral<Traits::Index>(i);
-      temporary.template AddLiteral<Traits::Mass>(f);
-      temporary.template AddLocal<Traits::Place>(Vec2 {}, "uv");
-
-      // Run octave code for this node                                  
-      temporary.Run(mCode);
-
-      // Generate shader code for octaves                               
-      auto& symbol = temporary.Generate();
-      octaves += Text::TemplateRt(FBMOctave, f, symbol.mCode);
+   if (mOctaveCount > mUnroll) {
+      Text weights;
+      for (Offset i = 0; i < mOctaveCount; ++i) {
+         if (i > 0)
+            weights += ", ";
+         weights += Text {f};
+         f *= mBaseWeight;
+      }
+
+      octaves = Text::TemplateRt(FBMLoop, mOctaveCount, weights);
+   }
+   else for (Offset i = 0; i < mOctaveCount && mBaseWeight != 0; ++i) {
+      octaves += Text::TemplateRt(FBMOctave, f,
+         Text::TemplateRt("FBMOctave(uv, {}, {})", i, f));
       if (i < mOctaveCount - 1)
          octaves += FBMRotate;
       f *= mBaseWeight;
@@ -79,3 +111,41 @@ const Symbol& FBM::Generate() {
    // Expose the FBM function template for use by the other nodes       
    return ExposeData<Real>("FBM({})", Traits::Place::OfType<Vec2>());
 }
+
+/// Bake the FBM into a texture, if the octave code is time-invariant - it    
+/// must read nothing but the octave's own parameters, so that it can be      
+/// evaluated once on the CPU, instead of in every pixel. Any other input,    
+/// like time, or the result of another node, keeps the FBM procedural.       
+/// Baking is opt-in, by giving the FBM node a Traits::Size, because the      
+/// baked texture tiles, which lowers the contrast towards its middle         
+///   @param octave - the compiled octave code                                
+///   @param uv - the coordinates, that the octave code was compiled with     
+///   @return true if FBM function was defined as a texture fetch             
+bool FBM::Bake(const Symbol& octave, const Symbol& uv) {
+   if (not mBakeSize or octave.mArguments
+   or static_cast<Token>(uv.mCode) != "uv")
+      return false;
+
+   // The octave must be a scalar, that the baker can evaluate          
+   const auto type = octave.mTrait.GetType();
+   if (not type or not type->template CastsTo<A::Number>(1))
+      return false;
+   if (not NoiseBaker::IsBakeable(static_cast<Token>(octave.mCode)))
+      return false;
+
+   NoiseBaker baker {mBakeSize, mOctaveCount, mBaseWeight, octave.mCode};
+   Neat descriptor;
+   descriptor << Traits::Size {Vec2u {mBakeSize}}
+              << Traits::Count {baker.GetMipCount()}
+              << baker.Bake()
+              << Traits::Parent {this};
+   auto local = Construct::From<A::Image>(descriptor);
+   Verbs::Create creator {&local};
+   mBaked = mMaterial->RunIn(creator)->As<A::Image*>();
+   VERBOSE_NODE("Baked noise into: ", mBaked);
+
+   const auto sampler = mMaterial->AddInput(Rate::Renderable,
+      Traits::Image::OfType<A::Image>(), true);
+   AddDefine("FBM", Text::TemplateRt(FBMBaked, "", sampler));
+   return true;
+}
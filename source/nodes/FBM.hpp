@@ -27,12 +27,25 @@ namespace Nodes
       Real mBaseWeight {0.5};
       // Number of octaves                                              
       Count mOctaveCount {2};
+      // Octave counts above this are generated as a loop               
+      Count mUnroll {8};
+      // Size of the texture, that time-invariant noise is baked into   
+      // The baked texture tiles, by blending its corners, which lowers 
+      // the contrast towards its middle, so this changes the look      
+      // Zero disables baking, which is the default                     
+      Count mBakeSize {};
+      // The baked noise texture, if any                                
+      Ref<A::Image> mBaked;
 
    public:
       FBM(Describe&&);
 
+      void Detach();
       const Symbol& Generate();
       operator Text() const;
+
+   private:
+      bool Bake(const Symbol&, const Symbol&);
    };
 
 } // namespace Nodes
@@ -52,6 +65,16 @@ constexpr Token FBMTemplate = R"shader(
    }}
 )shader";
 
+/// FBM octave function, compiled once from the octave code                   
+///   @param {0} - unique ID for the FBM function, used only in case of       
+///                multiple FBM nodes in hierarchy                            
+///   @param {1} - octave code, that can use uv, octave index, and mass       
+constexpr Token FBMOctaveFunction = R"shader(
+   float FBMOctave{0}(in vec2 uv, in int octave, in float mass) {{
+      return {1};
+   }}
+)shader";
+
 /// FBM octave template                                                       
 ///   @param {0} - mass trait for the current octave                          
 ///   @param {1} - octave code to execute                                     
@@ -64,6 +87,27 @@ constexpr Token FBMRotate = R"shader(
       uv = m * uv;
 )shader";
 
+/// FBM octave loop, used instead of unrolled octaves for high counts         
+///   @param {0} - number of octaves                                          
+///   @param {1} - comma-separated octave weights                             
+constexpr Token FBMLoop = R"shader(
+      const float weights[{0}] = float[{0}]({1});
+      for (int i = 0; i < {0}; i++) {{
+         f += weights[i] * FBMOctave(uv, i, weights[i]);
+         uv = m * uv;
+      }}
+)shader";
+
+/// FBM function that fetches a baked noise texture, instead of computing it  
+///   @param {0} - unique ID for the FBM function, used only in case of       
+///                multiple FBM nodes in hierarchy                            
+///   @param {1} - the sampler, that holds the baked noise                    
+constexpr Token FBMBaked = R"shader(
+   float FBM{0}(vec2 uv) {{
+      return texture({1}, uv).r;
+   }}
+)shader";
+
 /// FBM usage template                                                        
 ///   @param {0} - unique ID for the FBM function, used only in case of       
 ///                multiple FBM nodes in hierarchy                            
@@ -8,6 +8,8 @@
 #include "Raster.hpp"
 #include "Scene.hpp"
 #include "Camera.hpp"
+#include "Transform.hpp"
+#include "../Material.hpp"
 #include <Langulus/Mesh.hpp>
 
 using namespace Nodes;
@@ -24,6 +26,15 @@ Raster::Raster(Describe&& descriptor)
    mDescriptor.ExtractTrait<Traits::Topology>(mTopology);
    mDescriptor.ExtractTrait<Traits::Min>(mDepth.mMin);
    mDescriptor.ExtractTrait<Traits::Max>(mDepth.mMax);
+   mDescriptor.ExtractTrait<Traits::Setup>(mSetup);
+   mDescriptor.ExtractTrait<Traits::Tile>(mTile);
+   mDescriptor.ExtractTrait<Traits::Thickness>(mThickness);
+   LANGULUS_ASSERT(mThickness > 0, Material,
+      "Bad line thickness", mThickness);
+
+   // Binning works on precomputed triangle setups                      
+   if (mTile)
+      mSetup = true;
 
    // Extract rasterizer body                                           
    //mDescriptor.ExtractData(mCode);
@@ -35,51 +46,391 @@ Raster::Raster(Describe&& descriptor)
    }
 }
 
+/// Get the projected view transformation, without relying on Camera()        
+/// It is the same one, that the camera node of the rasterizer uses, or the   
+/// default screen projection, if there's no camera node                      
+///   @param consumer - the rate at which the projection is used              
+///   @return the GLSL code for the projected view (mat4)                     
+GLSL Raster::GetProjectedView(RefreshRate consumer) {
+   Camera* camera {};
+   ForEachChild([&](Camera& child) { camera = &child; });
+   return Camera::GetProjectedView(*this, camera, consumer);
+}
+
+/// Get the camera, that gives the screen position of each pixel              
+/// The default screen camera is defined, if there's no camera node           
+///   @return the GLSL code for the camera result                             
+GLSL Raster::GetCamera() {
+   bool explicitCamera = false;
+   ForEachChild([&](Camera&) { explicitCamera = true; });
+   if (not explicitCamera) {
+      auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+      LANGULUS_ASSERT(symRes, Material,
+         "No camera, or resolution available for rasterizer");
+      AddDefine("Camera", Text::TemplateRt(CameraFuncDefault, *symRes,
+         Camera::GetProjectedView(*this, nullptr, Rate::Pixel)));
+   }
+   return "Camera()";
+}
+
+/// Get the function, that transforms scene points before projecting them     
+/// It is the function of the first Transform node of the rasterizer, or      
+/// the identity Transform, if there's no such node                           
+///   @param consumer - the rate at which the function is called              
+///   @return the function name                                               
+GLSL Raster::GetTransform(RefreshRate consumer) {
+   Transform* transform {};
+   ForEachChild([&](Transform& child) {
+      if (not transform)
+         transform = &child;
+   });
+
+   if (not transform) {
+      mMaterial->AddDefine(consumer, "Transform", TransformIdentity);
+      return "Transform";
+   }
+
+   // The function is defined at the rate of the Transform node, so it  
+   // is copied to the consumer's stage, along with its dependencies    
+   const GLSL function {transform->GetFunction()};
+   LANGULUS_ASSERT(function, Material, "Transform node wasn't generated");
+   const auto rate = transform->GetRate();
+   if (rate.GetStageIndex() != consumer.GetStageIndex()) {
+      LANGULUS_ASSERT(mMaterial->Transplant(rate, consumer, GLSL {function, "(point)"}),
+         Material, "Transform function can't be used at rate ", consumer);
+   }
+   return function;
+}
+
+/// Rasterize each pixel, and expose the members of the result, that the      
+/// primitive fills in                                                        
+///   @param primitive - the primitive name (Triangle or Line)                
+///   @return the rasterizer function template                                
+const Symbol& Raster::GenerateResult(const Token& primitive) {
+   AddDefine("Rasterize",
+      Text::TemplateRt(RasterFunction, mDepth.mMax, primitive));
+   mMaterial->Commit(Rate::Pixel, ShaderToken::Transform,
+      Text::TemplateRt(RasterUsage, mDepth.mMax, GetCamera()));
+
+   ExposeTrait<Traits::Color, Vec4>("rasResult.mColor");
+   if (primitive == "Triangle") {
+      // Texture coordinate derivatives are computed analytically, and  
+      // exposed along with the coordinates they belong to, for         
+      // derivative-correct texture sampling                            
+      ExposeTrait<Traits::Sampler, Vec2>("rasResult.mUV");
+      ExposeTrait<Traits::Derivative, Vec4>("rasResult.mUVGrad");
+   }
+   return ExposeData<Raster>("Rasterize({})", MetaOf<Camera>());
+}
+
+/// Generate a compute stage, that precomputes the pixel-independent part of  
+/// each triangle once per frame - clip-space vertices, 1/w, the area         
+/// reciprocal and edge equations                                             
+///   @param scene - the scene triangle fetch symbol                          
+///   @param instances - number of instances, zero if not instanced           
+///   @param perInstance - number of triangles in the largest instance        
+///   @param culling - culling and sidedness code                             
+///   @return the number of triangle setups                                   
+Count Raster::GenerateTriangleSetup(const Symbol& scene, Count instances, Count perInstance, const GLSL& culling) {
+   const auto fetch = static_cast<Token>(scene.mCode);
+
+   GLSL index = "i";
+   GLSL model = "mat4(1.0)";
+   GLSL normalModel = "mat3(1.0)";
+   GLSL rejected = "false";
+   if (instances) {
+      // Instances are laid out in a grid of the largest instance size  
+      index = "cInstances[j].mStart + i";
+      model = "cInstances[j].mTransform";
+      normalModel = "cInstances[j].mNormalTransform";
+      rejected = "i >= cInstances[j].mCount";
+   }
+   else {
+      instances = 1;
+      perInstance = scene.mCount;
+   }
+
+   const auto total = instances * perInstance;
+   const auto binding = mMaterial->AddStorage({
+      "cTriangleSetup", {}, total * TriangleSetupSize
+   }, false);
+   mMaterial->SetDispatch({{(perInstance + 63) / 64, instances, 1}});
+
+   mMaterial->AddDefine(Rate::Compute, "TriangleSetup", TriangleSetupStruct);
+   mMaterial->AddDefine(Rate::Compute, "cTriangleSetup",
+      Text::TemplateRt(SetupBuffer, "writeonly", total, "Triangle", binding));
+   mMaterial->AddDefine(Rate::Compute, "SetupTriangle",
+      Text::TemplateRt(SetupTriangleFunction, culling,
+         GetTransform(Rate::Compute)));
+
+   mMaterial->Commit(Rate::Compute, ShaderToken::Input,
+      "layout(local_size_x = 64) in;\n");
+   mMaterial->Commit(Rate::Compute, ShaderToken::Transform,
+      Text::TemplateRt(SetupTriangleKernel, instances, perInstance,
+         Text::TemplateRt(fetch, index), model, rejected,
+         GetProjectedView(Rate::Compute), normalModel));
+
+   AddDefine("TriangleSetup", TriangleSetupStruct);
+   AddDefine("cTriangleSetup",
+      Text::TemplateRt(SetupBuffer, "readonly", total, "Triangle", binding));
+
+   VERBOSE_NODE("Triangle setup dispatched as ", instances, " x ",
+      perInstance, " invocations");
+   return total;
+}
+
+/// Generate a compute stage, that precomputes the pixel-independent part of  
+/// each line once per frame - clipped screen-space endpoints, 1/w, and       
+/// bounds extended by the line thickness                                     
+///   @param scene - the scene line fetch symbol                              
+///   @param pixel - size of a pixel in screen space                          
+///   @return the number of line setups                                       
+Count Raster::GenerateLineSetup(const Symbol& scene, const GLSL& pixel) {
+   const auto fetch = static_cast<Token>(scene.mCode);
+   const auto binding = mMaterial->AddStorage({
+      "cLineSetup", {}, scene.mCount * LineSetupSize
+   }, false);
+   mMaterial->SetDispatch({{(scene.mCount + 63) / 64, 1, 1}});
+
+   mMaterial->AddDefine(Rate::Compute, "LineSetup", LineSetupStruct);
+   mMaterial->AddDefine(Rate::Compute, "cLineSetup",
+      Text::TemplateRt(SetupBuffer, "writeonly", scene.mCount, "Line",
+         binding));
+   mMaterial->AddDefine(Rate::Compute, "SetupLine",
+      Text::TemplateRt(SetupLineFunction, pixel, mThickness,
+         GetTransform(Rate::Compute)));
+
+   mMaterial->Commit(Rate::Compute, ShaderToken::Input,
+      "layout(local_size_x = 64) in;\n");
+   mMaterial->Commit(Rate::Compute, ShaderToken::Transform,
+      Text::TemplateRt(SetupLineKernel, scene.mCount,
+         Text::TemplateRt(fetch, "i"), GetProjectedView(Rate::Compute)));
+
+   AddDefine("LineSetup", LineSetupStruct);
+   AddDefine("cLineSetup",
+      Text::TemplateRt(SetupBuffer, "readonly", scene.mCount, "Line",
+         binding));
+
+   VERBOSE_NODE("Line setup dispatched as ", scene.mCount, " invocations");
+   return scene.mCount;
+}
+
+/// Generate a compute pass, that bins precomputed primitive setups into      
+/// screen tiles, so that each pixel iterates only the primitives of its tile 
+///   @param setups - the number of primitive setups                          
+///   @param primitive - the primitive name (Triangle or Line)                
+void Raster::GenerateTileBinning(Count setups, const Token& primitive) {
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material, "Tile binning requires resolution");
+
+   // Tile heads scale with the resolution, and are cleared each frame. 
+   // Nodes come from a pool of bounded size, instead of reserving room 
+   // for every primitive in every tile                                 
+   const Count nodes = setups * TileNodesPerSetup;
+   const auto heads = mMaterial->AddStorage({
+      "cTileHead", {}, sizeof(uint32_t), mTile, sizeof(uint32_t), true
+   }, false);
+   const auto pool = mMaterial->AddStorage({
+      "cTileNodes", {}, nodes * 2 * sizeof(uint32_t)
+   }, false);
+
+   mMaterial->AddDefine(Rate::Compute, "cTileList",
+      Text::TemplateRt(TileBuffers, "coherent", heads, pool));
+   mMaterial->Commit(Rate::Compute, ShaderToken::Transform,
+      Text::TemplateRt(BinKernel, mTile, *symRes, nodes));
+
+   AddDefine("cTileList", Text::TemplateRt(TileBuffers, "readonly", heads, pool));
+   const Text function {"Rasterize", primitive, "List"};
+   AddDefine(static_cast<Token>(function),
+      Text::TemplateRt(RasterTileList, mTile, *symRes, primitive));
+   VERBOSE_NODE("Binning ", primitive, "s in ", mTile, "x", mTile, " tiles");
+}
+
+/// Generate line rasterizer definition code                                  
+/// Lines are rasterized per pixel, with analytic antialiased coverage, and   
+/// optionally precomputed and binned in a compute stage, same as triangles   
+const Symbol& Raster::GenerateLinesPerPixel() {
+   // Multiple scenes are merged in a single line array                 
+   TMany<const Nodes::Scene*> merged;
+   const auto owner = Nodes::Scene::FromChildren(*this, merged);
+   LANGULUS_ASSERT(owner, Material, "No scenes available for rasterizer");
+   const auto& scene = owner->GenerateLines(
+      mSetup ? Rate::Compute : Rate::Auto, merged);
+
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material, "Line rasterizer requires resolution");
+   const auto pixel = Text::TemplateRt("(2.0 / {}.x)", *symRes);
+
+   AddDefine("CameraResult", CameraResult);
+   AddDefine("RasterizeResult",
+      RasterResult);
+   AddDefine("RasterizeLineSetup",
+      Text::TemplateRt(RasterLineSetup, pixel, mThickness));
+
+   if (mSetup) {
+      // Only the distance to the segment is evaluated per pixel        
+      const auto setups = GenerateLineSetup(scene, pixel);
+      if (mTile)
+         GenerateTileBinning(setups, "Line");
+      else {
+         AddDefine("RasterizeLineList",
+            Text::TemplateRt(RasterSetupList, setups, "Line"));
+      }
+   }
+   else {
+      AddDefine("LineSetup", LineSetupStruct);
+      AddDefine("SetupLine",
+         Text::TemplateRt(SetupLineFunction, pixel, mThickness,
+            GetTransform(mRate)));
+      AddDefine("RasterizeLine", RasterLine);
+      AddDefine("RasterizeLineList", Text::TemplateRt(RasterLineList,
+         scene.mCount, Text::TemplateRt(static_cast<Token>(scene.mCode), "i")));
+   }
+
+   return GenerateResult("Line");
+}
+
 /// Generate rasterizer definition code                                       
 /// This is a 'fake' per-pixel rasterizer - very suboptimal, but useful in    
-/// various scenarios                                                         
+/// various scenarios. Setup can be precomputed per triangle in a compute     
+/// stage, so that only edge functions are evaluated per pixel                
 const Symbol& Raster::GeneratePerPixel() {
    // Generate children first                                           
    Descend();
 
-   // In order to rasterize per pixel, we require child scene nodes     
-   Symbols scenes;
-   ForEachChild([&scenes](Nodes::Scene& scene) {
-      scenes << scene.GenerateTriangles();
-   });
+   if (mTopology->template CastsTo<A::Line>())
+      return GenerateLinesPerPixel();
 
-   LANGULUS_ASSERT(scenes, Material, "No scenes available for rasterizer");
-
-   if (scenes.GetCount() > 1)
-      TODO(); // multiple triangle lists
+   // In order to rasterize per pixel, we require child scene nodes     
+   // If setup is precomputed, the triangles are consumed only in the   
+   // compute stage                                                     
+   // Multiple scenes are merged in a single triangle array, each scene 
+   // with its own range of instances                                   
+   TMany<const Nodes::Scene*> merged;
+   const auto owner = Nodes::Scene::FromChildren(*this, merged);
+   LANGULUS_ASSERT(owner, Material, "No scenes available for rasterizer");
+   const auto& scene = owner->GenerateTriangles(
+      mSetup ? Rate::Compute : Rate::Auto, merged);
+   const auto instances = owner->GetInstanceCount();
+   const auto perInstance = owner->GetInstanceTriangleCount();
 
    // Do face culling if required                                       
+   const Token rejection = mSetup ? "return result;" : "return;";
    GLSL culling;
    if (mBilateral)
       culling += "result.mFront = a <= 0.0;\n";
    else if (mSigned)
-      culling += "if (a >= 0.0) return;";
+      culling += Text {"if (a >= 0.0) ", rejection};
    else
-      culling += "if (a <= 0.0) return;";
+      culling += Text {"if (a <= 0.0) ", rejection};
 
    // Add rasterizer functions and dependencies                         
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material, "Rasterizer requires resolution");
+   const auto pixel = Text::TemplateRt("(2.0 / {}.x)", *symRes);
+   AddDefine("CameraResult", CameraResult);
    AddDefine("RasterizeResult",
       RasterResult);
+
+   if (mSetup) {
+      // Only edge functions are evaluated per pixel                    
+      const auto setups = GenerateTriangleSetup(scene,
+         instances, perInstance, culling);
+      AddDefine("RasterizeTriangleSetup",
+         Text::TemplateRt(RasterTriangleSetup, pixel));
+      if (mTile)
+         GenerateTileBinning(setups, "Triangle");
+      else {
+         AddDefine("RasterizeTriangleList",
+            Text::TemplateRt(RasterSetupList, setups, "Triangle"));
+      }
+      return GenerateResult("Triangle");
+   }
+
    AddDefine("RasterizeTriangle",
-      Text::TemplateRt(RasterTriangle, culling));
-   AddDefine("RasterizeTriangleList",
-      Text::TemplateRt(RasterTriangleList, scenes[0].mCount, scenes[0].mCode));
+      Text::TemplateRt(RasterTriangle, culling, pixel, GetTransform(mRate)));
 
-   return ExposeData<Raster>("Rasterize({})", MetaOf<Camera>());
+   // The scene symbol is a template for fetching a triangle by index   
+   const auto fetch = static_cast<Token>(scene.mCode);
+   if (instances) {
+      // Iterate instances x shared triangles                           
+      AddDefine("RasterizeTriangleList", Text::TemplateRt(RasterInstanceList,
+         instances, Text::TemplateRt(fetch, "j")));
+   }
+   else {
+      AddDefine("RasterizeTriangleList", Text::TemplateRt(RasterTriangleList,
+         scene.mCount, Text::TemplateRt(fetch, "i")));
+   }
+
+   return GenerateResult("Triangle");
+}
+
+/// Generate vertex pulling code, that feeds scene triangles to the hardware  
+/// rasterizer by gl_VertexIndex, so no vertex buffers are required           
+///   @param scene - the scene triangle fetch symbol                          
+///   @param instances - number of instances, zero if not instanced           
+///   @param perInstance - number of triangles in the largest instance        
+void Raster::GenerateVertexPulling(const Symbol& scene, Count instances, Count perInstance) {
+   const auto fetch = static_cast<Token>(scene.mCode);
+
+   GLSL index = "i";
+   GLSL model = "mat4(1.0)";
+   GLSL normalModel = "mat3(1.0)";
+   GLSL rejected = "false";
+   if (instances) {
+      // Each instance is drawn via gl_InstanceIndex, and the vertex    
+      // count of the draw call covers the largest instance, so the     
+      // excess vertices of smaller instances are rejected              
+      index = "cInstances[gl_InstanceIndex].mStart + i";
+      model = "cInstances[gl_InstanceIndex].mTransform";
+      normalModel = "cInstances[gl_InstanceIndex].mNormalTransform";
+      rejected = "i >= cInstances[gl_InstanceIndex].mCount";
+   }
+
+   AddDefine("PullVertex", Text::TemplateRt(RasterVertexPull,
+      Text::TemplateRt(fetch, index), model, rejected, normalModel,
+      GetTransform(mRate)));
+
+   // Pass interpolated attributes to the pixel stage                   
+   const auto uv = mMaterial->AddOutput(Rate::Vertex,
+      Traits::Sampler::OfType<Vec2>(), false);
+   const auto normal = mMaterial->AddOutput(Rate::Vertex,
+      Traits::Aim::OfType<Vec3>(), false);
+   mMaterial->AddInput(Rate::Pixel, Traits::Sampler::OfType<Vec2>(), false);
+   mMaterial->AddInput(Rate::Pixel, Traits::Aim::OfType<Vec3>(), false);
+
+   mMaterial->Commit(Rate::Vertex, ShaderToken::Transform,
+      Text::TemplateRt(RasterVertexPullUsage,
+         GetProjectedView(Rate::Vertex), uv, normal));
+
+   // No vertex buffers are bound, so the draw call size is exposed     
+   if (instances)
+      mMaterial->SetDraw(perInstance * 3, instances);
+   else
+      mMaterial->SetDraw(scene.mCount * 3, 1);
+   VERBOSE_NODE("Pulling ", scene.mCount, " triangles by vertex index");
 }
 
 /// Generate fixed-pipeline rasterizer                                        
-/// Uses the scene provided from the geometry shader, and rasterizes it using 
-/// the default hardware rasterizer. Exposes symbols PerPixel as a result     
+/// If there are child scenes, their triangles are pulled by gl_VertexIndex,  
+/// otherwise the bound vertex attributes are used. Either way the hardware   
+/// rasterizer does the coverage. Exposes symbols PerPixel as a result        
 ///   @return NoSymbol, as functionality is in the fixed-pipeline             
 const Symbol& Raster::GeneratePerVertex() {
-   auto position = GetSymbol<Traits::Place>(Rate::Vertex);
-   (void)position;
+   TMany<const Nodes::Scene*> merged;
+   const auto owner = Nodes::Scene::FromChildren(*this, merged);
+   if (owner) {
+      // Multiple scenes are merged in a single triangle array          
+      const auto& scene = owner->GenerateTriangles(Rate::Auto, merged);
+      GenerateVertexPulling(scene, owner->GetInstanceCount(),
+         owner->GetInstanceTriangleCount());
+   }
+   else {
+      // Use vertex attributes, that are bound as material inputs       
+      auto position = GetSymbol<Traits::Place>(Rate::Vertex);
+      LANGULUS_ASSERT(position, Material,
+         "No scenes or vertex positions available for rasterizer");
+   }
 
    AddDefine("gl_PerVertex",
       R"shader(
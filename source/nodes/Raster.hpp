@@ -31,6 +31,12 @@ namespace Nodes
       DMeta mTopology {};
       // The depth range in which we're rasterizing                     
       Range1 mDepth {0, 1000};
+      // Whether or not triangle setup is precomputed in a compute stage
+      bool mSetup {};
+      // Size of screen tiles for binning primitives, zero to disable   
+      Count mTile {};
+      // Thickness of rasterized lines, in pixels                       
+      Real mThickness {1};
 
    public:
       Raster(Describe&&);
@@ -39,30 +45,55 @@ namespace Nodes
 
    private:
       const Symbol& GeneratePerPixel();
+      const Symbol& GenerateLinesPerPixel();
       const Symbol& GeneratePerVertex();
+      void GenerateVertexPulling(const Symbol&, Count, Count);
+      Count GenerateTriangleSetup(const Symbol&, Count, Count, const GLSL&);
+      Count GenerateLineSetup(const Symbol&, const GLSL&);
+      void GenerateTileBinning(Count, const Token&);
+      const Symbol& GenerateResult(const Token&);
+      GLSL GetProjectedView(RefreshRate);
+      GLSL GetCamera();
+      GLSL GetTransform(RefreshRate);
    };
 
 } // namespace Nodes
 
 
 /// Rasterizer result                                                         
+/// mUVGrad holds the derivatives of mUV along the horizontal (xy) and        
+/// vertical (zw) pixel axes, for sampling with textureGrad, because the      
+/// implicit derivatives are discontinuous at triangle edges                  
 constexpr Token RasterResult = R"shader(
    struct RasterizeResult {
       vec3 mNormal;
       vec2 mUV;
+      vec4 mUVGrad;
+      vec4 mColor;
       float mDepth;
       int mTextureId;
    };
 )shader";
 
+/// Identity transformation of scene points, for rasterizers without a        
+/// Transform node                                                            
+constexpr Token TransformIdentity = R"shader(
+   vec4 Transform(in vec3 point) {
+      return vec4(point, 1.0);
+   }
+)shader";
+
 /// Rasterize single triangle                                                 
 ///   @param {0} - culling and sidedness code                                 
+///   @param {1} - size of a pixel in screen space                            
+///   @param {2} - point transformation function                              
 constexpr Token RasterTriangle = R"shader(
-   void RasterizeTriangle(in CameraResult camera, in Triangle triangle, inout RasterizeResult result) {{
+   void RasterizeTriangle(in CameraResult camera, in mat4 model, in mat3 normalModel, in Triangle triangle, inout RasterizeResult result) {{
       // Transform to eye space
-      vec4 pt0 = camera.mProjectedView * Transform(triangle.a);
-      vec4 pt1 = camera.mProjectedView * Transform(triangle.b);
-      vec4 pt2 = camera.mProjectedView * Transform(triangle.c);
+      const mat4 mvp = camera.mProjectedView * model;
+      vec4 pt0 = mvp * {2}(triangle.a);
+      vec4 pt1 = mvp * {2}(triangle.b);
+      vec4 pt2 = mvp * {2}(triangle.c);
 
       vec2 p0 = pt0.xy / pt0.w;
       vec2 p1 = pt1.xy / pt1.w;
@@ -105,50 +136,473 @@ constexpr Token RasterTriangle = R"shader(
             (triangle.aUV.y * test.w) / pt0.w
          ) * denominator;
 
+         // Barycentrics are linear in screen space, so their change per
+         // pixel is constant, and gives exact perspective-correct UV
+         // derivatives by the quotient rule
+         const float k = {1} / (2.0 * a);
+         const vec3 dx = vec3(p1.y - p2.y, p2.y - p0.y, p0.y - p1.y) * k;
+         const vec3 dy = vec3(p2.x - p1.x, p0.x - p2.x, p1.x - p0.x) * k;
+         const vec3 invW = 1.0 / vec3(pt0.w, pt1.w, pt2.w);
+         const vec3 u = vec3(triangle.aUV.x, triangle.bUV.x, triangle.cUV.x) * invW;
+         const vec3 v = vec3(triangle.aUV.y, triangle.bUV.y, triangle.cUV.y) * invW;
+         result.mUVGrad = vec4(
+            (vec2(dot(dx, u), dot(dx, v)) - result.mUV * dot(dx, invW)) * denominator,
+            (vec2(dot(dy, u), dot(dy, v)) - result.mUV * dot(dy, invW)) * denominator
+         );
+
          result.mDepth = z;
-         result.mNormal = triangle.n;
+         result.mNormal = normalize(normalModel * triangle.n);
       }}
    }}
 )shader";
 
 
-/// Rasterize single line                                                     
+/// Precomputed triangle setup, independent of the rasterized pixel           
+/// Barycentrics are planes in screen space, so that s = dot(mS, point),      
+/// where point is vec3(1.0, x, y). Attributes are premultiplied by 1/w for   
+/// perspective-correct interpolation. Culled triangles have mS.x = -1,       
+/// which rejects every pixel, and empty bounds (min > max)                   
+constexpr Token TriangleSetupStruct = R"shader(
+   struct TriangleSetup {
+      vec4 mBounds;
+      vec3 mS;
+      vec3 mT;
+      vec3 mInvW;
+      vec3 mDepth;
+      vec3 mU;
+      vec3 mV;
+      vec3 mNormal;
+   };
+)shader";
+
+/// Size of TriangleSetup in a std430 buffer                                  
+constexpr Size TriangleSetupSize = 128;
+
+/// Primitive setup storage buffer, written in the compute stage and read in  
+/// the pixel stage                                                           
+///   @param {0} - access qualifier                                           
+///   @param {1} - number of primitive setups                                 
+///   @param {2} - primitive name (Triangle or Line)                          
+///   @param {3} - binding index, given by Material::AddStorage               
+constexpr Token SetupBuffer = R"shader(
+   layout(set = 3, binding = {3})
+   {0} buffer {2}SetupBuffer {{
+      {2}Setup c{2}Setup[{1}];
+   }};
+)shader";
+
+/// Compute the setup of a single triangle                                    
 ///   @param {0} - culling and sidedness code                                 
-constexpr Token RasterLine = R"shader(
-   void RasterizeLine(in CameraResult camera, in Line line, inout RasterizeResult result) {{
-      TODO
+///   @param {1} - point transformation function                              
+constexpr Token SetupTriangleFunction = R"shader(
+   TriangleSetup SetupTriangle(in mat4 projectedView, in mat4 model, in mat3 normalModel, in Triangle triangle) {{
+      TriangleSetup result;
+      result.mS = vec3(-1.0, 0.0, 0.0);
+      result.mBounds = vec4(1.0, 1.0, -1.0, -1.0);
+
+      // Transform to eye space
+      const mat4 mvp = projectedView * model;
+      vec4 pt0 = mvp * {1}(triangle.a);
+      vec4 pt1 = mvp * {1}(triangle.b);
+      vec4 pt2 = mvp * {1}(triangle.c);
+
+      vec2 p0 = pt0.xy / pt0.w;
+      vec2 p1 = pt1.xy / pt1.w;
+      vec2 p2 = pt2.xy / pt2.w;
+
+      float a = 0.5 * (-p1.y * p2.x + p0.y * (-p1.x + p2.x) + p0.x * (p1.y - p2.y) + p1.x * p2.y);
+
+      {0}
+
+      // Screen bounds are unbounded, if the triangle crosses the eye
+      if (pt0.w <= 0.0 || pt1.w <= 0.0 || pt2.w <= 0.0)
+         result.mBounds = vec4(-1e30, -1e30, 1e30, 1e30);
+      else
+         result.mBounds = vec4(min(p0, min(p1, p2)), max(p0, max(p1, p2)));
+
+      const float area = 1.0 / (2.0 * a);
+      result.mS = area * vec3(p0.y * p2.x - p0.x * p2.y, p2.y - p0.y, p0.x - p2.x);
+      result.mT = area * vec3(p0.x * p1.y - p0.y * p1.x, p0.y - p1.y, p1.x - p0.x);
+
+      // Attributes are ordered a, b, c
+      result.mInvW = 1.0 / vec3(pt0.w, pt1.w, pt2.w);
+      result.mDepth = vec3(pt0.z, pt1.z, pt2.z) * result.mInvW;
+      result.mU = vec3(triangle.aUV.x, triangle.bUV.x, triangle.cUV.x) * result.mInvW;
+      result.mV = vec3(triangle.aUV.y, triangle.bUV.y, triangle.cUV.y) * result.mInvW;
+      result.mNormal = normalize(normalModel * triangle.n);
+      return result;
+   }}
+)shader";
+
+/// Triangle setup compute kernel - one invocation per instanced triangle     
+/// Dispatched as (ceil({1} / 64), {0}, 1) work groups                        
+///   @param {0} - number of instances                                        
+///   @param {1} - number of triangles per instance                           
+///   @param {2} - triangle fetch code for index i                            
+///   @param {3} - model transformation code                                  
+///   @param {4} - rejection code                                             
+///   @param {5} - projected view transformation (mat4)                       
+///   @param {6} - normal transformation code                                 
+constexpr Token SetupTriangleKernel = R"shader(
+   const int j = int(gl_GlobalInvocationID.y);
+   const int i = int(gl_GlobalInvocationID.x);
+   if (i >= {1} || j >= {0})
+      return;
+
+   const int setup = j * {1} + i;
+   if ({4}) {{
+      cTriangleSetup[setup].mS = vec3(-1.0, 0.0, 0.0);
+      cTriangleSetup[setup].mBounds = vec4(1.0, 1.0, -1.0, -1.0);
+      return;
+   }}
+
+   const TriangleSetup triangleSetup = SetupTriangle({5}, {3}, {6}, {2});
+   cTriangleSetup[setup] = triangleSetup;
+   const vec4 bounds = triangleSetup.mBounds;
+)shader";
+
+/// Precomputed line setup, independent of the rasterized pixel               
+/// Endpoints are in screen space, attributes are premultiplied by 1/w for    
+/// perspective-correct interpolation. Bounds are extended by the line        
+/// thickness, and are empty (min > max) for culled lines                     
+constexpr Token LineSetupStruct = R"shader(
+   struct LineSetup {
+      vec4 mBounds;
+      vec2 mP0;
+      vec2 mP1;
+      vec2 mInvW;
+      vec2 mDepth;
+      vec4 mColor0;
+      vec4 mColor1;
+   };
+)shader";
+
+/// Size of LineSetup in a std430 buffer                                      
+constexpr Size LineSetupSize = 80;
+
+/// Compute the setup of a single line                                        
+/// Lines are clipped against the eye plane, and culled if behind it          
+///   @param {0} - size of a pixel in screen space                            
+///   @param {1} - line thickness in pixels                                   
+///   @param {2} - point transformation function                              
+constexpr Token SetupLineFunction = R"shader(
+   LineSetup SetupLine(in mat4 projectedView, in Line line) {{
+      LineSetup result;
+      result.mBounds = vec4(1.0, 1.0, -1.0, -1.0);
+
+      vec4 pt0 = projectedView * {2}(line.a);
+      vec4 pt1 = projectedView * {2}(line.b);
+      vec4 color0 = line.aColor;
+      vec4 color1 = line.bColor;
+
+      const float near = 1e-5;
+      if (pt0.w <= near && pt1.w <= near)
+         return result;
+      else if (pt0.w <= near) {{
+         const float k = (near - pt0.w) / (pt1.w - pt0.w);
+         pt0 = mix(pt0, pt1, k);
+         color0 = mix(color0, color1, k);
+      }}
+      else if (pt1.w <= near) {{
+         const float k = (near - pt1.w) / (pt0.w - pt1.w);
+         pt1 = mix(pt1, pt0, k);
+         color1 = mix(color1, color0, k);
+      }}
+
+      result.mP0 = pt0.xy / pt0.w;
+      result.mP1 = pt1.xy / pt1.w;
+      result.mInvW = 1.0 / vec2(pt0.w, pt1.w);
+      result.mDepth = vec2(pt0.z, pt1.z) * result.mInvW;
+      result.mColor0 = color0 * result.mInvW.x;
+      result.mColor1 = color1 * result.mInvW.y;
+
+      const float extent = (0.5 * {1} + 1.0) * {0};
+      result.mBounds = vec4(
+         min(result.mP0, result.mP1) - extent,
+         max(result.mP0, result.mP1) + extent
+      );
+      return result;
    }}
 )shader";
 
+/// Line setup compute kernel - one invocation per line                       
+/// Dispatched as (ceil({0} / 64), 1, 1) work groups                          
+///   @param {0} - number of lines                                            
+///   @param {1} - line fetch code for index i                                
+///   @param {2} - projected view transformation (mat4)                       
+constexpr Token SetupLineKernel = R"shader(
+   const int i = int(gl_GlobalInvocationID.x);
+   if (i >= {0})
+      return;
+
+   const int setup = i;
+   const LineSetup lineSetup = SetupLine({2}, {1});
+   cLineSetup[setup] = lineSetup;
+   const vec4 bounds = lineSetup.mBounds;
+)shader";
+
+/// Number of tile list nodes, reserved for each primitive setup              
+/// Primitives, that overlap more tiles than that on average, are dropped     
+/// from the tiles binned last                                                
+constexpr Count TileNodesPerSetup = 16;
+
+/// Tile storage buffers, for binning primitive setups into screen tiles      
+/// Each tile is a linked list of nodes, appended to a shared node pool.      
+/// Heads point one past their first node, so that zero ends a list - the     
+/// head buffer must be cleared to zero before each dispatch                  
+///   @param {0} - access qualifier                                           
+///   @param {1} - head buffer binding, given by Material::AddStorage         
+///   @param {2} - node buffer binding, given by Material::AddStorage         
+constexpr Token TileBuffers = R"shader(
+   layout(set = 3, binding = {1})
+   {0} buffer TileHeadBuffer {{
+      uint cTileNodeCount;
+      uint cTileHead[];
+   }};
+
+   layout(set = 3, binding = {2})
+   {0} buffer TileNodeBuffer {{
+      uvec2 cTileNodes[];
+   }};
+)shader";
+
+/// Tile binning compute kernel, appended to a primitive setup kernel         
+/// Each primitive is added to the list of each tile its screen bounds overlap
+///   @param {0} - tile size in pixels                                        
+///   @param {1} - resolution symbol (vec2)                                   
+///   @param {2} - capacity of the node pool                                  
+constexpr Token BinKernel = R"shader(
+   if (bounds.x > bounds.z || bounds.y > bounds.w)
+      return;
+
+   // Convert bounds to gl_FragCoord space, and then to tiles
+   const ivec2 tiles = (ivec2({1}) + {0} - 1) / {0};
+   const vec2 lo = (bounds.xy * {1}.x + {1}) * 0.5;
+   const vec2 hi = (bounds.zw * {1}.x + {1}) * 0.5;
+   const ivec2 first = ivec2(clamp(floor(lo / float({0})), vec2(0.0), vec2(tiles - 1)));
+   const ivec2 last  = ivec2(clamp(floor(hi / float({0})), vec2(0.0), vec2(tiles - 1)));
+
+   for (int y = first.y; y <= last.y; y += 1) {{
+      for (int x = first.x; x <= last.x; x += 1) {{
+         const uint node = atomicAdd(cTileNodeCount, 1u);
+         if (node >= {2}u)
+            return;
+
+         const uint next = atomicExchange(cTileHead[y * tiles.x + x], node + 1u);
+         cTileNodes[node] = uvec2(uint(setup), next);
+      }}
+   }}
+)shader";
+
+/// Rasterize the precomputed primitives, binned to the tile of the pixel     
+///   @param {0} - tile size in pixels                                        
+///   @param {1} - resolution symbol (vec2)                                   
+///   @param {2} - primitive name (Triangle or Line)                          
+constexpr Token RasterTileList = R"shader(
+   void Rasterize{2}List(in CameraResult camera, inout RasterizeResult result) {{
+      const ivec2 tiles = (ivec2({1}) + {0} - 1) / {0};
+      const ivec2 tile = ivec2(gl_FragCoord.xy) / {0};
+      uint node = cTileHead[tile.y * tiles.x + tile.x];
+      while (node != 0u) {{
+         const uvec2 entry = cTileNodes[node - 1u];
+         Rasterize{2}Setup(camera, c{2}Setup[entry.x], result);
+         node = entry.y;
+      }}
+   }}
+)shader";
+
+/// Rasterize a single precomputed triangle - only edge functions and         
+/// interpolation are evaluated per pixel                                     
+///   @param {0} - size of a pixel in screen space                            
+constexpr Token RasterTriangleSetup = R"shader(
+   void RasterizeTriangleSetup(in CameraResult camera, in TriangleSetup setup, inout RasterizeResult result) {{
+      const vec3 point = vec3(1.0, camera.mScreenUV.x, -camera.mScreenUV.y);
+      const float s = dot(setup.mS, point);
+      const float t = dot(setup.mT, point);
+      if (s <= 0.0 || t <= 0.0 || 1.0 - s - t <= 0.0)
+         return;
+
+      const vec3 weights = vec3(1.0 - s - t, s, t);
+      const float denominator = 1.0 / dot(weights, setup.mInvW);
+      const float z = dot(weights, setup.mDepth) * denominator;
+      if (z < result.mDepth && z > 0.0) {{
+         const vec2 uv = vec2(dot(weights, setup.mU), dot(weights, setup.mV)) * denominator;
+         const vec3 dx = vec3(-setup.mS.y - setup.mT.y, setup.mS.y, setup.mT.y) * {0};
+         const vec3 dy = vec3(-setup.mS.z - setup.mT.z, setup.mS.z, setup.mT.z) * {0};
+         result.mUV = uv;
+         result.mUVGrad = vec4(
+            (vec2(dot(dx, setup.mU), dot(dx, setup.mV)) - uv * dot(dx, setup.mInvW)) * denominator,
+            (vec2(dot(dy, setup.mU), dot(dy, setup.mV)) - uv * dot(dy, setup.mInvW)) * denominator
+         );
+         result.mDepth = z;
+         result.mNormal = setup.mNormal;
+      }}
+   }}
+)shader";
+
+/// Rasterize a list of precomputed primitives                                
+///   @param {0} - number of primitive setups                                 
+///   @param {1} - primitive name (Triangle or Line)                          
+constexpr Token RasterSetupList = R"shader(
+   void Rasterize{1}List(in CameraResult camera, inout RasterizeResult result) {{
+      for (int i = 0; i < {0}; i += 1) {{
+         Rasterize{1}Setup(camera, c{1}Setup[i], result);
+      }}
+   }}
+)shader";
+
+/// Rasterize a single precomputed line, with analytic coverage               
+/// The distance from the pixel to the segment gives antialiased coverage,    
+/// that is multiplied into the color alpha                                   
+///   @param {0} - size of a pixel in screen space                            
+///   @param {1} - line thickness in pixels                                   
+constexpr Token RasterLineSetup = R"shader(
+   void RasterizeLineSetup(in CameraResult camera, in LineSetup setup, inout RasterizeResult result) {{
+      const vec2 point = vec2(camera.mScreenUV.x, -camera.mScreenUV.y);
+      if (any(lessThan(point, setup.mBounds.xy)) || any(greaterThan(point, setup.mBounds.zw)))
+         return;
+
+      const vec2 ab = setup.mP1 - setup.mP0;
+      const float h = clamp(dot(point - setup.mP0, ab) / max(dot(ab, ab), 1e-12), 0.0, 1.0);
+      const float distance = length(point - setup.mP0 - ab * h) / {0};
+      const float coverage = clamp(0.5 * {1} + 0.5 - distance, 0.0, 1.0);
+      if (coverage <= 0.0)
+         return;
+
+      const vec2 weights = vec2(1.0 - h, h);
+      const float denominator = 1.0 / dot(weights, setup.mInvW);
+      const float z = dot(weights, setup.mDepth) * denominator;
+      if (z < result.mDepth && z > 0.0) {{
+         result.mColor = (setup.mColor0 * weights.x + setup.mColor1 * weights.y) * denominator;
+         result.mColor.a *= coverage;
+         result.mDepth = z;
+      }}
+   }}
+)shader";
+
+/// Rasterize single line                                                     
+constexpr Token RasterLine = R"shader(
+   void RasterizeLine(in CameraResult camera, in Line line, inout RasterizeResult result) {
+      RasterizeLineSetup(camera, SetupLine(camera.mProjectedView, line), result);
+   }
+)shader";
+
 
 /// Rasterize a list of triangles                                             
 ///   @param {0} - number of triangles                                        
-///   @param {1} - triangle array name                                        
+///   @param {1} - triangle fetch code for index i                            
 constexpr Token RasterTriangleList = R"shader(
-   void RasterizeTriangleList(in CameraResult camera, inout RasterizeResult result) {
+   void RasterizeTriangleList(in CameraResult camera, inout RasterizeResult result) {{
       for (int i = 0; i < {0}; i += 1) {{
-         RasterizeTriangle(camera, {1}[i], result);
+         RasterizeTriangle(camera, mat4(1.0), mat3(1.0), {1}, result);
+      }}
+   }}
+)shader";
+
+/// Rasterize a list of instances, each referencing a range of triangles      
+///   @param {0} - number of instances                                        
+///   @param {1} - triangle fetch code for index j                            
+constexpr Token RasterInstanceList = R"shader(
+   void RasterizeTriangleList(in CameraResult camera, inout RasterizeResult result) {{
+      for (int i = 0; i < {0}; i += 1) {{
+         const Instance instance = cInstances[i];
+         const int end = instance.mStart + instance.mCount;
+         for (int j = instance.mStart; j < end; j += 1) {{
+            RasterizeTriangle(camera, instance.mTransform, instance.mNormalTransform, {1}, result);
+         }}
       }}
    }}
 )shader";
 
 /// Rasterize a list of lines                                                 
 ///   @param {0} - number of lines                                            
-///   @param {1} - line array name                                            
+///   @param {1} - line fetch code for index i                                
 constexpr Token RasterLineList = R"shader(
-   void RasterizeLineList(in CameraResult camera, inout RasterizeResult result) {
+   void RasterizeLineList(in CameraResult camera, inout RasterizeResult result) {{
       for (int i = 0; i < {0}; i += 1) {{
-         RasterizeLine(camera, {1}[i], result);
+         RasterizeLine(camera, {1}, result);
       }}
    }}
 )shader";
 
-/// Rasterizer usage snippet                                                  
+/// Pull a scene vertex by gl_VertexIndex, for the hardware rasterizer        
+/// Each three consecutive vertices make a triangle, so a draw call of        
+/// 3 * N vertices, without any vertex buffers, covers N scene triangles      
+///   @param {0} - triangle fetch code for index i                            
+///   @param {1} - model transformation code                                  
+///   @param {2} - culling code, rejects the triangle when it returns true    
+///   @param {3} - normal transformation code                                 
+///   @param {4} - point transformation function                              
+constexpr Token RasterVertexPull = R"shader(
+   struct RasterizeVertex {{
+      vec4 mPosition;
+      vec3 mNormal;
+      vec2 mUV;
+   }};
+
+   RasterizeVertex PullVertex(in mat4 projectedView) {{
+      const int i = gl_VertexIndex / 3;
+      const int corner = gl_VertexIndex - i * 3;
+      const mat4 model = {1};
+      const mat3 normalModel = {3};
+
+      RasterizeVertex result;
+      if ({2}) {{
+         // Degenerate vertex, gets clipped by the rasterizer
+         result.mPosition = vec4(0.0);
+         return result;
+      }}
+
+      const Triangle triangle = {0};
+      const vec3 position = corner == 0 ? triangle.a
+                          : corner == 1 ? triangle.b
+                          :               triangle.c;
+      result.mUV = corner == 0 ? triangle.aUV
+                 : corner == 1 ? triangle.bUV
+                 :               triangle.cUV;
+      result.mPosition = projectedView * model * {4}(position);
+      result.mNormal = normalize(normalModel * triangle.n);
+      return result;
+   }}
+)shader";
+
+/// Vertex pulling usage snippet                                              
+///   @param {0} - projected view transformation (mat4)                       
+///   @param {1} - texture coordinate output                                  
+///   @param {2} - normal output                                              
+constexpr Token RasterVertexPullUsage = R"shader(
+   const RasterizeVertex rasVertex = PullVertex({0});
+   gl_Position = rasVertex.mPosition;
+   {1} = rasVertex.mUV;
+   {2} = rasVertex.mNormal;
+)shader";
+
+/// Rasterize all primitives into an initialized result                       
+/// Pixels, that aren't covered by any primitive, are left at the max depth.  
+/// Color is white, unless a primitive carries one, so that modulating by it  
+/// doesn't change anything for triangles                                     
+///   @param {0} - max depth                                                  
+///   @param {1} - primitive name (Triangle or Line)                          
+constexpr Token RasterFunction = R"shader(
+   RasterizeResult Rasterize(in CameraResult camera) {{
+      RasterizeResult result;
+      result.mNormal = vec3(0.0);
+      result.mUV = vec2(0.0);
+      result.mUVGrad = vec4(0.0);
+      result.mColor = vec4(1.0);
+      result.mDepth = {0};
+      result.mTextureId = -1;
+      Rasterize{1}List(camera, result);
+      return result;
+   }}
+)shader";
+
+/// Rasterizer usage snippet, that declares the result the rasterizer traits  
+/// are exposed from                                                          
 ///   @param {0} - max depth                                                  
+///   @param {1} - camera code                                                
 constexpr Token RasterUsage = R"shader(
-   RasterizeResult rasResult;
-   rasResult.mDepth = {0};
-   SceneRAS(camResult, rasResult);
+   RasterizeResult rasResult = Rasterize({1});
    if (rasResult.mDepth >= {0})
       discard;
    rasResult.mDepth = 1.0 - rasResult.mDepth / {0};
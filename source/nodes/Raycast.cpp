@@ -6,6 +6,8 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #include "Raycast.hpp"
+#include "Scene.hpp"
+#include "Camera.hpp"
 
 using namespace Nodes;
 
@@ -14,12 +16,28 @@ using namespace Nodes;
 ///   @param desc - raycast descriptor                                        
 Raycast::Raycast(Describe&& descriptor)
    : Resolvable {this}
-   , Node {*descriptor} { }
+   , Node {*descriptor} {
+   mDescriptor.ExtractTrait<Traits::Max>(mFarMax);
+   LANGULUS_ASSERT(mFarMax > 0, Material,
+      "Bad raycasting far plane", mFarMax);
+}
 
 /// Generate the raycaster code                                               
 ///   @return the raycaster function template                                 
 const Symbol& Raycast::Generate() {
+   // Generate children first                                           
    Descend();
-   TODO();
-   return NoSymbol;
+
+   // In order to raycast, we require child scene nodes, made only of   
+   // primitives with analytic intersections                            
+   TMany<const Nodes::Scene*> merged;
+   const auto owner = Nodes::Scene::FromChildren(*this, merged);
+   LANGULUS_ASSERT(owner, Material, "No scenes available for raycaster");
+   owner->GenerateIntersections(Rate::Auto, merged);
+
+   // Add raycasting functions and dependencies                         
+   AddDefine("RaycastResult", RaycastResult);
+   AddDefine("Raycast", Text::TemplateRt(RaycastFunction, mFarMax));
+
+   return ExposeData<Raycast>("Raycast({})", MetaOf<Camera>());
 }
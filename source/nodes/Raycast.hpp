@@ -19,8 +19,33 @@ namespace Nodes
       LANGULUS(ABSTRACT) false;
       LANGULUS_BASES(Node);
 
+   private:
+      // Max raycasting distance, used to normalize depth               
+      float mFarMax {1000.0f};
+
+   public:
       Raycast(Describe&&);
       const Symbol& Generate();
    };
 
-} // namespace Nodes
\ No newline at end of file
+} // namespace Nodes
+
+
+/// Raycast result                                                            
+constexpr Token RaycastResult = R"shader(
+   struct RaycastResult {
+      float mDepth;
+   };
+)shader";
+
+/// Raycast function, that intersects the camera ray with the scene           
+/// Depth is normalized the same way the Raymarch node does it                
+///   @param {0} - max raycasting distance                                    
+constexpr Token RaycastFunction = R"shader(
+   RaycastResult Raycast(in CameraResult camera) {{
+      const float t = Intersect(camera.mOrigin, camera.mDirection);
+      if (t < 0.0)
+         return RaycastResult(0.0);
+      return RaycastResult(1.0 - min(t, {0}) / {0});
+   }}
+)shader";
@@ -40,6 +40,161 @@ Raymarch::Raymarch(Describe&& descriptor)
       "Bad raymarching base stride", mBaseStride);
    LANGULUS_ASSERT(mMinStep > 0, Material,
       "Bad raymarching min step", mMinStep);
+
+   // Extract the marching strategy                                     
+   Text strategy;
+   if (mDescriptor.ExtractTrait<Traits::Strategy>(strategy)) {
+      if (strategy == "Hybrid")
+         mStrategy = Strategy::Hybrid;
+      else if (strategy == "AdaptiveBisect")
+         mStrategy = Strategy::AdaptiveBisect;
+      else if (strategy == "OverRelaxed")
+         mStrategy = Strategy::OverRelaxed;
+      else if (strategy == "ConeSafe")
+         mStrategy = Strategy::ConeSafe;
+      else
+         LANGULUS_THROW(Material, "Unknown raymarching strategy");
+   }
+
+   // Extract the prepass tile size and the downsampling factor         
+   mDescriptor.ExtractTrait<Traits::Tile>(mPrepass);
+   mDescriptor.ExtractTrait<Traits::Downsample>(mDownsample);
+   LANGULUS_ASSERT(mDownsample > 0, Material,
+      "Bad raymarching downsampling factor", mDownsample);
+   LANGULUS_ASSERT(not mPrepass or mDownsample == 1, Material,
+      "Raymarching prepass can't be combined with downsampling");
+}
+
+/// Get the angular size of a single pixel, used to stop marching as soon as  
+/// further refinement isn't visible                                          
+///   @param scale - number of pixels a single ray accounts for, per axis     
+///   @return the GLSL code for the pixel footprint                           
+GLSL Raymarch::GetPixelFootprint(Count scale) {
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material,
+      "Raymarching strategy requires resolution");
+
+   // Screen UVs span 2 units horizontally, and the field of view       
+   // scales the ray direction, same as in the Camera node              
+   auto symFov = GetSymbol<Traits::FOV, Real>(Rate::Camera);
+   if (symFov)
+      return Text::TemplateRt("({}.0 / ({}.x * {}))", scale * 2, *symRes, *symFov);
+   return Text::TemplateRt("({}.0 / {}.x)", scale * 2, *symRes);
+}
+
+/// Define CameraRay() in the compute stage, so that rays can be cast for     
+/// arbitrary fragments, the same way the Camera node casts them per pixel    
+///   @param resolution - the resolution symbol                               
+void Raymarch::GenerateComputeRays(const Symbol& resolution) {
+   mMaterial->AddDefine(Rate::Compute, "CameraResult", CameraResult);
+   auto symView = GetSymbol<Traits::View, Mat4>(Rate::Level);
+   auto symFov  = GetSymbol<Traits::FOV,  Real>(Rate::Camera);
+   if (symView and symFov) {
+      mMaterial->AddDefine(Rate::Compute, "CameraRay",
+         Text::TemplateRt(CameraRayPerPixel, resolution, *symView, *symFov));
+   }
+   else {
+      mMaterial->AddDefine(Rate::Compute, "CameraRay",
+         Text::TemplateRt(CameraRayDefault, resolution));
+   }
+}
+
+/// Generate a low-resolution cone-marching prepass in a compute stage        
+/// It writes a conservative start depth per tile, that skips the empty       
+/// space in front of the scene for all rays inside that tile                 
+///   @param scene - the scene function name                                  
+///   @return the GLSL code for reading the start depth in the pixel stage    
+GLSL Raymarch::GeneratePrepass(const Token& scene) {
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material,
+      "Raymarching prepass requires resolution");
+
+   // Cones are cast from the same camera as the full resolution rays,  
+   // one invocation per tile, in 8x8 work groups                       
+   GenerateComputeRays(*symRes);
+   const auto binding = mMaterial->AddStorage({
+      "cRaymarchStart", MetaOf<float>(), 0, mPrepass
+   }, false);
+   mMaterial->SetDispatch({{0, 0, 1}, mPrepass, {8, 8}});
+
+   mMaterial->AddDefine(Rate::Compute, "cRaymarchStart",
+      Text::TemplateRt(RaymarchStartImage, "writeonly", binding));
+   mMaterial->Commit(Rate::Compute, ShaderToken::Input,
+      "layout(local_size_x = 8, local_size_y = 8) in;\n");
+   mMaterial->Commit(Rate::Compute, ShaderToken::Transform,
+      Text::TemplateRt(RaymarchPrepassKernel, mPrepass, *symRes,
+         GetPixelFootprint(), mFarMax, mDetail, scene));
+
+   AddDefine("cRaymarchStart",
+      Text::TemplateRt(RaymarchStartImage, "readonly", binding));
+   VERBOSE_NODE("Cone-marching prepass in ", mPrepass, "x", mPrepass, " tiles");
+   return Text::TemplateRt(
+      "imageLoad(cRaymarchStart, ivec2(gl_FragCoord.xy) / {}).r", mPrepass);
+}
+
+/// March at reduced resolution in a compute stage, and reconstruct the full  
+/// resolution in the pixel stage, using a depth-aware bilateral upsample     
+///   @param scene - the scene function name                                  
+void Raymarch::GenerateDownsampled(const Token& scene) {
+   auto symRes = GetSymbol<Traits::Size, Vec2>(Rate::Tick);
+   LANGULUS_ASSERT(symRes, Material,
+      "Downsampled raymarching requires resolution");
+
+   GenerateComputeRays(*symRes);
+   mMaterial->AddDefine(Rate::Compute, "RaymarchResult", RaymarchResult);
+   GenerateMarcher(Rate::Compute, scene, "0.0", mDownsample);
+
+   // One invocation per block of pixels, in 8x8 work groups            
+   const auto binding = mMaterial->AddStorage({
+      "cRaymarchDepth", MetaOf<float>(), 0, mDownsample
+   }, false);
+   mMaterial->SetDispatch({{0, 0, 1}, mDownsample, {8, 8}});
+
+   mMaterial->AddDefine(Rate::Compute, "cRaymarchDepth",
+      Text::TemplateRt(RaymarchDepthImage, "writeonly", binding));
+   mMaterial->Commit(Rate::Compute, ShaderToken::Input,
+      "layout(local_size_x = 8, local_size_y = 8) in;\n");
+   mMaterial->Commit(Rate::Compute, ShaderToken::Transform,
+      Text::TemplateRt(RaymarchDownsampledKernel, mDownsample, *symRes));
+
+   AddDefine("cRaymarchDepth",
+      Text::TemplateRt(RaymarchDepthImage, "readonly", binding));
+   AddDefine("Raymarch", Text::TemplateRt(RaymarchUpsample,
+      scene, mDownsample, mFarMax, *symRes));
+   VERBOSE_NODE("Raymarching at 1/", mDownsample, " resolution");
+}
+
+/// Generate the marcher function for the selected strategy                   
+/// Only the functions required by the strategy are emitted                   
+///   @param rate - the stage to generate the marcher in                      
+///   @param scene - the scene function name                                  
+///   @param start - initial distance along the ray                           
+///   @param scale - number of pixels a single ray accounts for, per axis     
+void Raymarch::GenerateMarcher(RefreshRate rate, const Token& scene, const GLSL& start, Count scale) {
+   switch (mStrategy) {
+   case Strategy::Hybrid:
+      mMaterial->AddDefine(rate, "Bisect", Text::TemplateRt(RaymarchBisect,
+         scene, mPrecision));
+      mMaterial->AddDefine(rate, "Raymarch", Text::TemplateRt(RaymarchFunction,
+         scene, mPrecision, mFarMax, mFarStride, mBaseStride,
+         mMinStep, mDetail, start));
+      break;
+   case Strategy::AdaptiveBisect:
+      mMaterial->AddDefine(rate, "Bisect", Text::TemplateRt(RaymarchBisectAdaptive,
+         scene, mPrecision, GetPixelFootprint(scale)));
+      mMaterial->AddDefine(rate, "Raymarch", Text::TemplateRt(RaymarchFunction,
+         scene, mPrecision, mFarMax, mFarStride, mBaseStride,
+         mMinStep, mDetail, start));
+      break;
+   case Strategy::OverRelaxed:
+      mMaterial->AddDefine(rate, "Raymarch", Text::TemplateRt(RaymarchOverRelaxed,
+         scene, mPrecision, mFarMax, mDetail, start));
+      break;
+   case Strategy::ConeSafe:
+      mMaterial->AddDefine(rate, "Raymarch", Text::TemplateRt(RaymarchConeSafe,
+         scene, GetPixelFootprint(scale), mFarMax, mDetail, start, mPrecision));
+      break;
+   }
 }
 
 /// Generate raymarcher code                                                  
@@ -49,21 +204,30 @@ const Symbol& Raymarch::Generate() {
    Descend();
 
    // In order to raymarch, we require child scene nodes                
-   Symbols scenes;
-   ForEachChild([&scenes](Nodes::Scene& scene) {
-      scenes << scene.GenerateSDF();
-   });
+   // Multiple scenes are merged in a single Scene function, that       
+   // combines all their elements in one union tree                     
+   TMany<const Nodes::Scene*> merged;
+   const auto owner = Nodes::Scene::FromChildren(*this, merged);
+   LANGULUS_ASSERT(owner, Material, "No scenes available for raymarcher");
+   // The optional prepass marches the same scene in a compute stage,   
+   // and provides the initial distance for the full resolution march   
+   // Downsampled marching happens entirely in the compute stage        
+   if (mPrepass or mDownsample > 1)
+      owner->GenerateSDF(Rate::Compute, merged);
 
-   LANGULUS_ASSERT(scenes, Material, "No scenes available for raymarcher");
+   GLSL start = "0.0";
+   if (mPrepass)
+      start = GeneratePrepass("Scene");
 
-   if (scenes.GetCount() > 1)
-      TODO(); // another SDFUnion indirection required here
+   owner->GenerateSDF(Rate::Auto, merged);
 
    // Add raymarching functions and dependencies                        
-   AddDefine("Raymarch", Text::TemplateRt(RaymarchFunction,
-      scenes[0].mCode, mPrecision, mFarMax, mFarStride, mBaseStride, 
-      mMinStep, mDetail)
-   );
+   // When downsampling, the pixel stage only reconstructs the march    
+   AddDefine("RaymarchResult", RaymarchResult);
+   if (mDownsample > 1)
+      GenerateDownsampled("Scene");
+   else
+      GenerateMarcher(mRate, "Scene", start);
 
    return ExposeData<Raymarch>("Raymarch({})", MetaOf<Camera>());
 }
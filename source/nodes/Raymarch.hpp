@@ -18,6 +18,18 @@ namespace Nodes
       LANGULUS(ABSTRACT) false;
       LANGULUS_BASES(Node);
 
+      /// Available marching strategies, selected via Traits::Strategy        
+      enum class Strategy {
+         // Log-bisect hybrid marcher, with a fixed number of bisections
+         Hybrid,
+         // Hybrid marcher, that bisects until below pixel footprint    
+         AdaptiveBisect,
+         // Over-relaxed sphere tracing                                 
+         OverRelaxed,
+         // Relaxed stepping, that terminates on the pixel cone         
+         ConeSafe
+      };
+
    private:
       // Raymarcher precision                                           
       float mPrecision {0.008f};
@@ -37,34 +49,41 @@ namespace Nodes
       float mMinStep {0.1f};
       // Max number of raymarching steps                                
       int mDetail {60};
+      // The marching strategy                                          
+      Strategy mStrategy {Strategy::Hybrid};
+      // Size of the cone-marching prepass tiles in pixels              
+      // Zero disables the prepass                                      
+      Count mPrepass {};
+      // Resolution divisor of the compute stage march, that is then    
+      // upsampled in the pixel stage. One marches at full resolution   
+      Count mDownsample {1};
 
    public:
       Raymarch(Describe&&);
       const Symbol& Generate();
+
+   private:
+      GLSL GetPixelFootprint(Count = 1);
+      void GenerateComputeRays(const Symbol&);
+      GLSL GeneratePrepass(const Token&);
+      void GenerateDownsampled(const Token&);
+      void GenerateMarcher(RefreshRate, const Token&, const GLSL&, Count = 1);
    };
 
 } // namespace Nodes
 
 
-/// Raymarch function                                                         
-///   @param {0} - scene function symbol                                      
-///   @param {1} - precision                                                  
-///   @param {2} - max raymarching distance                                   
-///   @param {3} - far stride, used by the hybrid marcher                     
-///                if the distance from the root is high enough we use d      
-///                instead of log(d)                                          
-///   @param {4} - base stride, used by the hybrid marcher                    
-///                determines how fast the root finder moves in, needs to be  
-///                lowered when dealing with thin "slices". the potential     
-///                problem is the intersector crossing the function twice in  
-///                one step                                                   
-///   @param {5} - a minimum step size                                        
-///   @param {6} - max number of raymarching steps                            
-constexpr Token RaymarchFunction = R"shader(
-   struct RaymarchResult {{
+/// Raymarch result                                                           
+constexpr Token RaymarchResult = R"shader(
+   struct RaymarchResult {
       float mDepth;
-   }};
+   };
+)shader";
 
+/// Bisection with a fixed number of iterations                               
+///   @param {0} - scene function symbol                                      
+///   @param {1} - precision                                                  
+constexpr Token RaymarchBisect = R"shader(
    // This modified(!) implementation of Log-Bisect-Raymarching is
    // based on nimitz's original code, without his permission or endorsement:
    // https://www.shadertoy.com/view/4sSXzD
@@ -83,9 +102,50 @@ constexpr Token RaymarchFunction = R"shader(
 
       return (near + far) * 0.5;
    }}
+)shader";
+
+/// Bisection, that stops as soon as the interval is below pixel footprint    
+/// Distant intersections need fewer iterations, than close ones              
+///   @param {0} - scene function symbol                                      
+///   @param {1} - precision                                                  
+///   @param {2} - pixel footprint (angular size of a pixel)                  
+constexpr Token RaymarchBisectAdaptive = R"shader(
+   float Bisect(in CameraResult camera, in float near, in float far) {{
+      float sgn = sign({0}(camera.mDirection * near + camera.mOrigin));
+      for (int i = 0; i < 16; i++) {{
+         const float mid = (near + far) * 0.5;
+         if (far - near < {2} * mid)
+            break;
+
+         float d = {0}(camera.mDirection * mid + camera.mOrigin);
+         if (abs(d) < {1})
+            return mid;
+
+         d * sgn < 0.0 ? far = mid : near = mid;
+      }}
+
+      return (near + far) * 0.5;
+   }}
+)shader";
 
+/// Hybrid log-bisect raymarch function                                       
+///   @param {0} - scene function symbol                                      
+///   @param {1} - precision                                                  
+///   @param {2} - max raymarching distance                                   
+///   @param {3} - far stride, used by the hybrid marcher                     
+///                if the distance from the root is high enough we use d      
+///                instead of log(d)                                          
+///   @param {4} - base stride, used by the hybrid marcher                    
+///                determines how fast the root finder moves in, needs to be  
+///                lowered when dealing with thin "slices". the potential     
+///                problem is the intersector crossing the function twice in  
+///                one step                                                   
+///   @param {5} - a minimum step size                                        
+///   @param {6} - max number of raymarching steps                            
+///   @param {7} - initial distance along the ray                             
+constexpr Token RaymarchFunction = R"shader(
    RaymarchResult Raymarch(in CameraResult camera) {{
-      float t = 0.0;
+      float t = {7};
       float d = {0}(camera.mDirection * t + camera.mOrigin);
       float sgn = sign(d);
       float told = t;
@@ -113,3 +173,193 @@ constexpr Token RaymarchFunction = R"shader(
       return RaymarchResult(1.0 - t / {2});
    }}
 )shader";
+
+/// Over-relaxed sphere tracing function                                      
+/// Steps further than the distance bound, and steps back once, if spheres of 
+/// consecutive steps stop overlapping. Based on "Enhanced Sphere Tracing" by 
+/// Keinert et al.                                                            
+///   @param {0} - scene function symbol                                      
+///   @param {1} - precision                                                  
+///   @param {2} - max raymarching distance                                   
+///   @param {3} - max number of raymarching steps                            
+///   @param {4} - initial distance along the ray                             
+constexpr Token RaymarchOverRelaxed = R"shader(
+   RaymarchResult Raymarch(in CameraResult camera) {{
+      float omega = 1.6;
+      float t = {4};
+      float previousRadius = 0.0;
+      float stepLength = 0.0;
+      const float sgn = sign({0}(camera.mDirection * t + camera.mOrigin));
+
+      for (int i = 0; i < {3}; i++) {{
+         const float signedRadius = sgn * {0}(camera.mDirection * t + camera.mOrigin);
+         const float radius = abs(signedRadius);
+         const bool failed = omega > 1.0 && radius + previousRadius < stepLength;
+         if (failed) {{
+            // Spheres don't overlap - step back and stop relaxing
+            stepLength -= omega * stepLength;
+            omega = 1.0;
+         }}
+         else {{
+            if (radius < {1})
+               return RaymarchResult(1.0 - t / {2});
+            stepLength = signedRadius * omega;
+         }}
+
+         previousRadius = radius;
+         t += stepLength;
+         if (t >= {2})
+            break;
+      }}
+
+      return RaymarchResult(0.0);
+   }}
+)shader";
+
+/// Relaxed cone-safe stepping function                                       
+/// Steps are relaxed again after each successful one, and marching stops as  
+/// soon as the distance is below the radius of the pixel cone, which is when 
+/// further steps can't change the pixel anymore                              
+///   @param {0} - scene function symbol                                      
+///   @param {1} - pixel footprint (angular size of a pixel)                  
+///   @param {2} - max raymarching distance                                   
+///   @param {3} - max number of raymarching steps                            
+///   @param {4} - initial distance along the ray                             
+///   @param {5} - precision                                                  
+constexpr Token RaymarchConeSafe = R"shader(
+   RaymarchResult Raymarch(in CameraResult camera) {{
+      float t = {4};
+      float previousRadius = 0.0;
+      float stepLength = 0.0;
+      float bestT = {2};
+      float bestError = 1e32;
+      const float sgn = sign({0}(camera.mDirection * t + camera.mOrigin));
+
+      for (int i = 0; i < {3}; i++) {{
+         const float signedRadius = sgn * {0}(camera.mDirection * t + camera.mOrigin);
+         const float radius = abs(signedRadius);
+         if (radius + previousRadius < stepLength) {{
+            // Overshot - step back, and take an unrelaxed step
+            t -= stepLength;
+            stepLength = previousRadius;
+            t += stepLength;
+            previousRadius = 0.0;
+            continue;
+         }}
+
+         const float cone = {1} * max(t, {5});
+         const float error = radius / cone;
+         if (error < bestError) {{
+            bestT = t;
+            bestError = error;
+         }}
+
+         if (radius < cone)
+            break;
+
+         previousRadius = radius;
+         stepLength = signedRadius * 1.4;
+         t += stepLength;
+         if (t >= {2})
+            break;
+      }}
+
+      if (bestError > 1.0)
+         bestT = {2};
+      return RaymarchResult(1.0 - bestT / {2});
+   }}
+)shader";
+
+/// Start depth image, written by the prepass and read by the full march      
+///   @param {0} - access qualifier                                           
+///   @param {1} - binding index, given by Material::AddStorage               
+constexpr Token RaymarchStartImage = R"shader(
+   layout(set = 3, binding = {1}, r32f)
+   {0} uniform image2D cRaymarchStart;
+)shader";
+
+/// Low-resolution cone-marching prepass kernel                               
+/// One invocation marches a cone, that encloses the rays of a whole tile of  
+/// pixels. Steps never exceed the distance that is free for the whole cone,  
+/// so the stored depth is a safe start for every ray inside the tile         
+///   @param {0} - tile size in pixels                                        
+///   @param {1} - resolution symbol (vec2)                                   
+///   @param {2} - pixel footprint                                            
+///   @param {3} - max raymarching distance                                   
+///   @param {4} - max number of steps                                        
+///   @param {5} - scene function symbol                                      
+constexpr Token RaymarchPrepassKernel = R"shader(
+   const ivec2 tile = ivec2(gl_GlobalInvocationID.xy);
+   const ivec2 tiles = (ivec2({1}) + {0} - 1) / {0};
+   if (any(greaterThanEqual(tile, tiles)))
+      return;
+
+   // Cone radius per unit distance covers the tile diagonal,
+   // with an additional pixel of margin
+   const float cone = {2} * float({0} + 1) * 0.7072;
+   const CameraResult camera = CameraRay((vec2(tile) + 0.5) * float({0}));
+   float t = 0.0;
+   for (int i = 0; i < {4}; i++) {{
+      const float d = {5}(camera.mDirection * t + camera.mOrigin);
+      if (d <= cone * t || t >= {3})
+         break;
+      t += (d - cone * t) / (1.0 + cone);
+   }}
+
+   imageStore(cRaymarchStart, tile, vec4(min(t, {3})));
+)shader";
+
+/// Reduced resolution depth image, written by the compute stage march        
+///   @param {0} - access qualifier                                           
+///   @param {1} - binding index, given by Material::AddStorage               
+constexpr Token RaymarchDepthImage = R"shader(
+   layout(set = 3, binding = {1}, r32f)
+   {0} uniform image2D cRaymarchDepth;
+)shader";
+
+/// Reduced resolution raymarching kernel                                     
+/// One invocation marches the ray through the center of a block of pixels    
+///   @param {0} - downsampling factor                                        
+///   @param {1} - resolution symbol (vec2)                                   
+constexpr Token RaymarchDownsampledKernel = R"shader(
+   const ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+   const ivec2 size = (ivec2({1}) + {0} - 1) / {0};
+   if (any(greaterThanEqual(texel, size)))
+      return;
+
+   const CameraResult camera = CameraRay((vec2(texel) + 0.5) * float({0}));
+   imageStore(cRaymarchDepth, texel, vec4(Raymarch(camera).mDepth));
+)shader";
+
+/// Depth-aware bilateral upsampling of the reduced resolution march          
+/// The four nearest samples are weighted bilinearly, and by how close the    
+/// full resolution ray gets to the surface at each sample's depth, so that   
+/// depth discontinuities don't bleed over silhouettes                        
+///   @param {0} - scene function symbol                                      
+///   @param {1} - downsampling factor                                        
+///   @param {2} - max raymarching distance                                   
+///   @param {3} - resolution symbol (vec2)                                   
+constexpr Token RaymarchUpsample = R"shader(
+   RaymarchResult Raymarch(in CameraResult camera) {{
+      const vec2 position = gl_FragCoord.xy / float({1}) - 0.5;
+      const ivec2 base = ivec2(floor(position));
+      const ivec2 last = (ivec2({3}) + {1} - 1) / {1} - 1;
+      const vec2 f = position - floor(position);
+
+      float depthSum = 0.0;
+      float weightSum = 0.0;
+      for (int i = 0; i < 4; i++) {{
+         const ivec2 offset = ivec2(i & 1, i >> 1);
+         const float depth = imageLoad(cRaymarchDepth,
+            clamp(base + offset, ivec2(0), last)).r;
+         const vec2 bilinear = mix(1.0 - f, f, vec2(offset));
+         const float t = (1.0 - depth) * {2};
+         const float error = abs({0}(camera.mDirection * t + camera.mOrigin));
+         const float weight = bilinear.x * bilinear.y / (error + 0.0001);
+         depthSum += depth * weight;
+         weightSum += weight;
+      }}
+
+      return RaymarchResult(depthSum / max(weightSum, 0.00000001));
+   }}
+)shader";
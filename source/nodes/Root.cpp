@@ -24,9 +24,9 @@ Root::Root(Material* producer, const Many& desc)
 }
 
 /// Generate the shader stages                                                
+///   @return NoSymbol, as the root only generates its children               
 auto Root::Generate() -> const Symbol& {
    // Just generate children                                            
    Descend();
-   TODO();
    return NoSymbol;
 }
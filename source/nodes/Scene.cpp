@@ -7,6 +7,8 @@
 ///                                                                           
 #include "Scene.hpp"
 #include "../Material.hpp"
+#include "../Decimator.hpp"
+#include "../Packing.hpp"
 #include <Langulus/Mesh.hpp>
 #include <Langulus/Math/Color.hpp>
 #include <Langulus/Math/Normal.hpp>
@@ -24,6 +26,16 @@ Scene::Scene(Describe&& descriptor)
    // How the scene is generated depends on whether we're rasterizing,  
    // raymarching, raytracing, etc.                                     
    //InnerCreate();
+
+   // Extract optional simplification settings - a triangle budget,     
+   // and/or the maximum allowed error                                  
+   mDescriptor.ExtractTrait<Traits::Count>(mTriangleBudget);
+   mDescriptor.ExtractTrait<Traits::Max>(mMaxError);
+   LANGULUS_ASSERT(mMaxError >= 0, Material,
+      "Bad scene simplification error", mMaxError);
+
+   // Extract optional triangle compression                             
+   mDescriptor.ExtractTrait<Traits::Compressed>(mCompressed);
 }
 
 /// Generate scene code                                                       
@@ -37,13 +49,22 @@ const Symbol& Scene::Generate() {
 }
 
 /// Generate scene code                                                       
+///   @param rate - the rate at which lines are consumed, the node's own      
+///                 rate is used if Rate::Auto                                
+///   @param merged - other scenes to merge into this one                     
 ///   @return the array of lines symbol                                       
-const Symbol& Scene::GenerateLines() {
+const Symbol& Scene::GenerateLines(RefreshRate rate, const TMany<const Scene*>& merged) {
+   // Lines are generated on demand, in the stage that consumes them,   
+   // so the rate is overridden only for the duration of this call      
+   const auto previousRate = mRate;
+   if (rate != Rate::Auto)
+      mRate = rate;
+
    GLSL lines;
    Count countCombined = 0;
 
    // Get the lines of each geometry construct                          
-   mDescriptor.ForEachConstruct([&](const Construct& c) {
+   const auto gather = [&](const Construct& c) {
       if (not c.CastsTo<A::Mesh>())
          return;
 
@@ -88,7 +109,12 @@ const Symbol& Scene::GenerateLines() {
          lines += ")";
          ++countCombined;
       }
-   });
+   };
+
+   // Gather this scene and all merged ones in a single array           
+   this->mDescriptor.ForEachConstruct(gather);
+   for (auto source : merged)
+      source->mDescriptor.ForEachConstruct(gather);
 
    LANGULUS_ASSERT(countCombined, Material, "No lines available");
 
@@ -99,60 +125,609 @@ const Symbol& Scene::GenerateLines() {
    //   );                                                              
    AddDefine("Line", LineStruct);
    AddDefine("cLines", Text::TemplateRt(LineList, countCombined, lines));
-   return ExposeData<Scene>("cLines");
+
+   // Expose the line fetch template, along with the number of lines    
+   auto& symbol = ExposeData<Scene>("cLines[{}]", Traits::Index::OfType<int>());
+   symbol.mCount = countCombined;
+   mRate = previousRate;
+   return symbol;
 }
 
 /// Interpret a construct as an SDF function                                  
 ///   @param what - the construct to reinterpret                              
 ///   @param global - place where global definitions go                       
+///   @param rate - the rate at which definitions are added                   
 ///   @return the generated scene function call                               
-GLSL InterpretAsSDF(const Construct&, Material&) {
-   TODO();
-   return {};
+static GLSL InterpretAsSDF(const Construct& what, Material& global, RefreshRate rate) {
+   // Primitives are centered around an optional offset                 
+   Vec3 offset;
+   what.GetDescriptor().ExtractTrait<Traits::Place>(offset);
+   const auto point = Text::TemplateRt("point - {}", GLSL {offset});
+
+   GLSL call;
+   what.GetDescriptor().ForEachDeep(
+      [&](const Box3& box) {
+         global.AddDefine(rate, "SDFBox3", SDFBox3);
+         call = Text::TemplateRt("SDFBox3({}, {})",
+            point, GLSL {box.mOffsets});
+      },
+      [&](const BoxRounded3& box) {
+         global.AddDefine(rate, "SDFBoxRounded3", SDFBoxRounded3);
+         call = Text::TemplateRt("SDFBoxRounded3({}, {}, {})",
+            point, GLSL {box.mOffsets}, box.mRadius);
+      },
+      [&](const ConeX& cone) {
+         global.AddDefine(rate, "SDFConeX",
+            Text::TemplateRt(SDFCone, "X", "yz", "x"));
+         call = Text::TemplateRt("SDFConeX({}, {}, {})",
+            point, cone.mAngle, cone.mHeight);
+      },
+      [&](const ConeY& cone) {
+         global.AddDefine(rate, "SDFConeY",
+            Text::TemplateRt(SDFCone, "Y", "xz", "y"));
+         call = Text::TemplateRt("SDFConeY({}, {}, {})",
+            point, cone.mAngle, cone.mHeight);
+      },
+      [&](const ConeZ& cone) {
+         global.AddDefine(rate, "SDFConeZ",
+            Text::TemplateRt(SDFCone, "Z", "xy", "z"));
+         call = Text::TemplateRt("SDFConeZ({}, {}, {})",
+            point, cone.mAngle, cone.mHeight);
+      },
+      [&](const CylinderX& cyl) {
+         global.AddDefine(rate, "SDFCylinderX",
+            Text::TemplateRt(SDFCylinder, "X", "yz"));
+         call = Text::TemplateRt("SDFCylinderX({}, {})",
+            point, cyl.mRadius);
+      },
+      [&](const CylinderY& cyl) {
+         global.AddDefine(rate, "SDFCylinderY",
+            Text::TemplateRt(SDFCylinder, "Y", "xz"));
+         call = Text::TemplateRt("SDFCylinderY({}, {})",
+            point, cyl.mRadius);
+      },
+      [&](const CylinderZ& cyl) {
+         global.AddDefine(rate, "SDFCylinderZ",
+            Text::TemplateRt(SDFCylinder, "Z", "xy"));
+         call = Text::TemplateRt("SDFCylinderZ({}, {})",
+            point, cyl.mRadius);
+      }
+   );
+
+   LANGULUS_ASSERT(call, Material,
+      "Geometry has no signed distance function");
+   return call;
+}
+
+/// Interpret a construct as a repeated SDF function, if it has a period      
+///   @param what - the construct to reinterpret                              
+///   @param global - place where global definitions go                       
+///   @param rate - the rate at which definitions are added                   
+///   @param index - index of the construct, used for unique function names   
+///   @return the generated scene function call                               
+static GLSL InterpretAsRepeatedSDF(const Construct& what, Material& global, RefreshRate rate, Offset index) {
+   Vec3 period;
+   if (not what.GetDescriptor().ExtractTrait<Traits::Repeat>(period))
+      return InterpretAsSDF(what, global, rate);
+
+   // The element itself is generated as if it is in the first cell     
+   auto element = what;
+   element.GetDescriptor().template RemoveTrait<Traits::Repeat>();
+
+   // Axes with non-positive period aren't repeated                     
+   Vec3 reciprocal;
+   for (Offset i = 0; i < 3; ++i)
+      reciprocal[i] = period[i] > 0 ? Real {1} / period[i] : Real {0};
+
+   // Optionally bound the number of cells on each axis, starting from  
+   // the origin and going towards positive infinity                    
+   GLSL cell;
+   Vec3 count;
+   if (element.GetDescriptor().ExtractTrait<Traits::Count>(count)) {
+      element.GetDescriptor().template RemoveTrait<Traits::Count>();
+      for (Offset i = 0; i < 3; ++i) {
+         LANGULUS_ASSERT(count[i] >= 1, Material,
+            "Bad domain repetition count", count);
+      }
+      cell = Text::TemplateRt(SDFRepeatCellBounded,
+         GLSL {reciprocal}, GLSL {count - Real {1}});
+   }
+   else cell = Text::TemplateRt(SDFRepeatCell, GLSL {reciprocal});
+
+   // Optionally vary each cell by a pseudo-random offset, hashed from  
+   // the cell index. It must stay below half the period, because       
+   // neighbor cells aren't evaluated, and the distance field breaks    
+   // otherwise                                                         
+   GLSL variation;
+   Vec3 amplitude;
+   if (element.GetDescriptor().ExtractTrait<Traits::Variation>(amplitude)) {
+      element.GetDescriptor().template RemoveTrait<Traits::Variation>();
+      for (Offset i = 0; i < 3; ++i) {
+         LANGULUS_ASSERT(period[i] <= 0 or ::std::abs(amplitude[i]) * 2 < period[i],
+            Material, "Domain repetition variation must stay below half the period",
+            amplitude, period);
+      }
+
+      global.AddDefine(rate, "SDFHash3", SDFHash3);
+      variation = Text::TemplateRt(SDFRepeatVariation, GLSL {amplitude});
+   }
+
+   const Text name = Text::TemplateRt("SDFRepeat{}", index);
+   global.AddDefine(rate, static_cast<Token>(name), Text::TemplateRt(SDFRepeatFunction,
+      name, GLSL {period}, cell, variation, InterpretAsSDF(element, global, rate)));
+   return Text::TemplateRt("{}(point)", name);
+}
+
+/// Combine SDF elements in a balanced tree of unions                         
+/// Nesting depth grows logarithmically, instead of linearly with the number  
+/// of elements                                                               
+///   @param elements - the elements to combine                               
+///   @param first - the first element in the subtree                         
+///   @param count - number of elements in the subtree                        
+///   @return the combined scene code                                         
+static GLSL SDFUnionTree(const TMany<GLSL>& elements, Offset first, Count count) {
+   if (count == 1)
+      return elements[first];
+
+   const auto half = count / 2;
+   return Text::TemplateRt(SDFUnionUsage,
+      SDFUnionTree(elements, first, half),
+      SDFUnionTree(elements, first + half, count - half));
 }
 
 /// Generate scene code                                                       
+/// Other scenes can be merged into this one, so that they're all evaluated   
+/// by a single Scene function                                                
+///   @param rate - the stage to generate the scene function in               
+///   @param merged - other scenes to merge into this one                     
 ///   @return the SDF scene function template symbol                          
-const Symbol& Scene::GenerateSDF() {
-   GLSL scene;
+const Symbol& Scene::GenerateSDF(RefreshRate rate, const TMany<const Scene*>& merged) {
+   // The SDF can be required by more than one stage, so the rate is    
+   // overridden only for the duration of this call                     
+   const auto previousRate = mRate;
+   if (rate != Rate::Auto)
+      mRate = rate;
+
+   TMany<const Scene*> sources;
+   sources << this;
+   sources += merged;
+
+   // Get the SDF code for each geometry construct of each scene        
+   TMany<GLSL> elements;
+   for (auto source : sources) {
+      source->mDescriptor.ForEachConstruct([&](const Construct& c) {
+         if (not c.CastsTo<A::Mesh>())
+            return;
+
+         elements << InterpretAsRepeatedSDF(c, *mMaterial,
+            GetRate(), elements.GetCount());
+      });
+   }
+
+   LANGULUS_ASSERT(elements, Material, "SDF scene is empty");
+
+   // Consecutive elements are SDFUnion'ed                              
+   if (elements.GetCount() > 1)
+      AddDefine("SDFUnion", SDFUnion);
+   const auto scene = SDFUnionTree(elements, 0, elements.GetCount());
 
-   // Get the SDF code for each geometry construct                      
-   mDescriptor.ForEachConstruct([&](const Construct& c) {
-      if (not c.CastsTo<A::Mesh>())
-         return;
+   // Define the scene function                                         
+   AddDefine("Scene", Text::TemplateRt(SceneFunction, scene));
 
-      auto element = InterpretAsSDF(c, *mMaterial);
-      if (not scene) {
-         // This was the first element                                  
-         scene = element;
-         return;
+   // Expose scene usage                                                
+   const auto& symbol = ExposeTrait<Traits::D, float>(
+      "Scene({})", Traits::Place::OfType<Vec3>());
+   mRate = previousRate;
+   return symbol;
+}
+
+/// Interpret a construct as an analytic ray intersection                     
+/// Only primitives with closed-form intersections are supported              
+///   @param what - the construct to reinterpret                              
+///   @param global - place where global definitions go                       
+///   @param rate - the rate at which definitions are added                   
+///   @return the generated intersection function call                        
+static GLSL InterpretAsIntersection(const Construct& what, Material& global, RefreshRate rate) {
+   Vec3 period;
+   const bool repeated = what.GetDescriptor().ExtractTrait<Traits::Repeat>(period);
+   LANGULUS_ASSERT(not repeated, Material,
+      "Repeated geometry can't be intersected analytically");
+
+   // Primitives are centered around an optional offset                 
+   Vec3 offset;
+   what.GetDescriptor().ExtractTrait<Traits::Place>(offset);
+   const auto origin = Text::TemplateRt("origin - {}", GLSL {offset});
+
+   GLSL call;
+   what.GetDescriptor().ForEachDeep(
+      [&](const Box3& box) {
+         global.AddDefine(rate, "IntersectBox3", IntersectBox3);
+         call = Text::TemplateRt("IntersectBox3({}, direction, {})",
+            origin, GLSL {box.mOffsets});
+      },
+      [&](const BoxRounded3& box) {
+         global.AddDefine(rate, "IntersectBoxRounded3", IntersectBoxRounded3);
+         call = Text::TemplateRt("IntersectBoxRounded3({}, direction, {}, {})",
+            origin, GLSL {box.mOffsets}, box.mRadius);
+      },
+      [&](const ConeX& cone) {
+         global.AddDefine(rate, "IntersectConeX",
+            Text::TemplateRt(IntersectCone, "X", "yz", "x"));
+         call = Text::TemplateRt("IntersectConeX({}, direction, {}, {})",
+            origin, cone.mAngle, cone.mHeight);
+      },
+      [&](const ConeY& cone) {
+         global.AddDefine(rate, "IntersectConeY",
+            Text::TemplateRt(IntersectCone, "Y", "xz", "y"));
+         call = Text::TemplateRt("IntersectConeY({}, direction, {}, {})",
+            origin, cone.mAngle, cone.mHeight);
+      },
+      [&](const ConeZ& cone) {
+         global.AddDefine(rate, "IntersectConeZ",
+            Text::TemplateRt(IntersectCone, "Z", "xy", "z"));
+         call = Text::TemplateRt("IntersectConeZ({}, direction, {}, {})",
+            origin, cone.mAngle, cone.mHeight);
+      },
+      [&](const CylinderX& cyl) {
+         global.AddDefine(rate, "IntersectCylinderX",
+            Text::TemplateRt(IntersectCylinder, "X", "yz"));
+         call = Text::TemplateRt("IntersectCylinderX({}, direction, {})",
+            origin, cyl.mRadius);
+      },
+      [&](const CylinderY& cyl) {
+         global.AddDefine(rate, "IntersectCylinderY",
+            Text::TemplateRt(IntersectCylinder, "Y", "xz"));
+         call = Text::TemplateRt("IntersectCylinderY({}, direction, {})",
+            origin, cyl.mRadius);
+      },
+      [&](const CylinderZ& cyl) {
+         global.AddDefine(rate, "IntersectCylinderZ",
+            Text::TemplateRt(IntersectCylinder, "Z", "xy"));
+         call = Text::TemplateRt("IntersectCylinderZ({}, direction, {})",
+            origin, cyl.mRadius);
       }
+   );
 
-      // Each consecutive element is SDFUnion'ed                        
-      // Define the union operation if not yet defined                  
-      AddDefine("SDFUnion", SDFUnion);
+   LANGULUS_ASSERT(call, Material,
+      "Geometry has no analytic intersection");
+   return call;
+}
 
-      // Nest the union function for each new element                   
-      scene = Text::TemplateRt(SDFUnionUsage, scene, element);
-   });
+/// Generate analytic ray intersection code                                   
+/// Instead of marching a distance field, each primitive is intersected in    
+/// closed form, and the nearest hit is picked                                
+///   @param rate - the stage to generate the intersection function in        
+///   @param merged - other scenes to merge into this one                     
+///   @return the intersection function template symbol                       
+const Symbol& Scene::GenerateIntersections(RefreshRate rate, const TMany<const Scene*>& merged) {
+   // The rate is overridden only for the duration of this call         
+   const auto previousRate = mRate;
+   if (rate != Rate::Auto)
+      mRate = rate;
+
+   TMany<const Scene*> sources;
+   sources << this;
+   sources += merged;
+
+   // Each element is folded into the nearest hit so far                
+   AddDefine("NearestHit", IntersectNearest);
+   GLSL hits;
+   for (auto source : sources) {
+      source->mDescriptor.ForEachConstruct([&](const Construct& c) {
+         if (not c.CastsTo<A::Mesh>())
+            return;
+
+         hits += Text::TemplateRt("t = NearestHit(t, {});\n",
+            InterpretAsIntersection(c, *mMaterial, GetRate()));
+      });
+   }
+
+   LANGULUS_ASSERT(hits, Material, "Intersected scene is empty");
+   AddDefine("Intersect", Text::TemplateRt(IntersectFunction, hits));
+
+   const auto& symbol = ExposeTrait<Traits::D, float>("Intersect({}, {})",
+      Traits::Place::OfType<Vec3>(), Traits::Aim::OfType<Vec3>());
+   mRate = previousRate;
+   return symbol;
+}
 
-   LANGULUS_ASSERT(scene, Material, "SDF scene is empty");
+/// Compute the normal transformation of an instance - the inverse transpose  
+/// of the upper 3x3 part of its model transformation. Its columns are the    
+/// cross products of the model's columns, divided by the determinant         
+///   @param model - the model transformation                                 
+///   @return the normal transformation                                       
+static Mat3 NormalTransform(const Mat4& model) {
+   const Vec3 c0 {model[0], model[1], model[2]};
+   const Vec3 c1 {model[4], model[5], model[6]};
+   const Vec3 c2 {model[8], model[9], model[10]};
+   const Vec3 columns[3] {c1.Cross(c2), c2.Cross(c0), c0.Cross(c1)};
+   const auto determinant = c0.Dot(columns[0]);
+   LANGULUS_ASSERT(determinant != 0, Material,
+      "Instance transformation is degenerate");
+
+   Mat3 result;
+   for (Offset c = 0; c < 3; ++c) {
+      for (Offset r = 0; r < 3; ++r)
+         result[c * 3 + r] = columns[c][r] / determinant;
+   }
+   return result;
+}
 
-   // Define the scene function                                         
-   AddDefine("Scene", Text::TemplateRt(SceneFunction, scene));
+/// Get a vertex attribute as a given type, converting it if needed           
+///   @tparam T - the type to get                                             
+///   @param data - the attribute data of a triangle                          
+///   @param index - the vertex index inside the triangle                     
+///   @return the attribute                                                   
+template<CT::Data T>
+static T GetAttribute(const Many& data, Offset index) {
+   if (data.template CastsTo<T>(1))
+      return data.template As<T>(index);
+   return data.template AsCast<T>(index);
+}
 
-   // Expose scene usage                                                
-   return ExposeTrait<Traits::D, float>("Scene({})", Traits::Place::OfType<Vec3>());
+/// Gather the triangles of a mesh, one triangle at a time                    
+/// This is the slow path, used when mesh data isn't laid out in a way that   
+/// allows for bulk gathering, so attributes of any type are converted        
+///   @param mesh - the mesh to gather triangles from                         
+///   @param output - [out] the gathered triangles go here                    
+static void GatherTrianglesSlow(const A::Mesh& mesh, TMany<Scene::Triangle>& output) {
+   const auto count = mesh.GetTriangleCount();
+   for (Count i = 0; i < count; ++i) {
+      auto position = mesh.template GetTriangleTrait<Traits::Place>(i);
+      LANGULUS_ASSERT(position, Material,
+         "Can't rasterize a triangle without Traits::Place");
+
+      auto normal = mesh.template GetTriangleTrait<Traits::Aim>(i);
+      LANGULUS_ASSERT(normal, Material,
+         "Can't rasterize a triangle without Traits::Aim");
+
+      auto texture = mesh.template GetTriangleTrait<Traits::Sampler>(i);
+      LANGULUS_ASSERT(texture, Material,
+         "Can't rasterize a triangle without Traits::Sampler");
+
+      output << Scene::Triangle {
+         GetAttribute<Vec3>(position, 0), GetAttribute<Vec2>(texture, 0),
+         GetAttribute<Vec3>(position, 1), GetAttribute<Vec2>(texture, 1),
+         GetAttribute<Vec3>(position, 2), GetAttribute<Vec2>(texture, 2),
+         GetAttribute<Vec3>(normal, 0)
+      };
+   }
+}
+
+/// Check if mesh data is a dense array of a given type                       
+///   @tparam T - the type to check for                                       
+///   @param data - the mesh data to check                                    
+///   @return true if data can be accessed directly as an array of T          
+template<CT::Data T>
+static bool IsDenseArrayOf(const Many* data) {
+   return data and data->template CastsTo<T>(1)
+      and data->GetStride() == sizeof(T);
+}
+
+/// Gather all triangles of a mesh in bulk                                    
+/// Positions, normals, texture coordinates and indices are fetched from the  
+/// mesh only once, and then converted in a single tight loop, without any    
+/// intermediate containers or type checks per triangle                       
+///   @param mesh - the mesh to gather triangles from                         
+///   @param output - [out] the gathered triangles go here                    
+///   @return true if mesh was suitable for bulk gathering                    
+static bool GatherTrianglesBulk(const A::Mesh& mesh, TMany<Scene::Triangle>& output) {
+   // Only plain triangle lists can be gathered in bulk                 
+   const auto topology = mesh.GetTopology();
+   if (not topology or not topology->template Is<A::Triangle>())
+      return false;
+
+   const auto positions = mesh.template GetData<Traits::Place>();
+   const auto normals   = mesh.template GetData<Traits::Aim>();
+   const auto samplers  = mesh.template GetData<Traits::Sampler>();
+   if (not IsDenseArrayOf<Vec3>(positions)
+   or  not IsDenseArrayOf<Vec3>(normals)
+   or  not IsDenseArrayOf<Vec2>(samplers))
+      return false;
+
+   // Attributes must be per-vertex                                     
+   const auto vertexCount = positions->GetCount();
+   if (normals->GetCount() != vertexCount
+   or  samplers->GetCount() != vertexCount)
+      return false;
+
+   const auto pos = positions->template GetRawAs<Vec3>();
+   const auto nrm = normals->template GetRawAs<Vec3>();
+   const auto uvs = samplers->template GetRawAs<Vec2>();
+
+   // Convert all triangles in a single pass                            
+   const auto convert = [&](const auto* indices, Count indexCount) {
+      const auto triangleCount = indexCount / 3;
+      output.Reserve(output.GetCount() + triangleCount);
+      for (Offset i = 0; i < triangleCount; ++i) {
+         const Offset i0 = indices[i * 3 + 0];
+         const Offset i1 = indices[i * 3 + 1];
+         const Offset i2 = indices[i * 3 + 2];
+         LANGULUS_ASSERT(
+            i0 < vertexCount and i1 < vertexCount and i2 < vertexCount,
+            Material, "Triangle index out of range");
+
+         output << Scene::Triangle {
+            pos[i0], uvs[i0],
+            pos[i1], uvs[i1],
+            pos[i2], uvs[i2],
+            nrm[i0]
+         };
+      }
+   };
+
+   const auto indices = mesh.template GetData<Traits::Index>();
+   if (not indices or not *indices) {
+      // Not indexed, so every three consecutive vertices are a triangle
+      const auto triangleCount = vertexCount / 3;
+      output.Reserve(output.GetCount() + triangleCount);
+      for (Offset i = 0; i < triangleCount * 3; i += 3) {
+         output << Scene::Triangle {
+            pos[i + 0], uvs[i + 0],
+            pos[i + 1], uvs[i + 1],
+            pos[i + 2], uvs[i + 2],
+            nrm[i]
+         };
+      }
+      return true;
+   }
+
+   if (IsDenseArrayOf<uint32_t>(indices))
+      convert(indices->template GetRawAs<uint32_t>(), indices->GetCount());
+   else if (IsDenseArrayOf<uint16_t>(indices))
+      convert(indices->template GetRawAs<uint16_t>(), indices->GetCount());
+   else if (IsDenseArrayOf<uint8_t>(indices))
+      convert(indices->template GetRawAs<uint8_t>(), indices->GetCount());
+   else
+      return false;
+   return true;
+}
+
+/// Serialize gathered triangles to a GLSL array initializer                  
+///   @param triangles - the triangles to serialize                           
+///   @return the GLSL code                                                   
+static GLSL SerializeTriangles(const TMany<Scene::Triangle>& triangles) {
+   GLSL code;
+   for (auto& t : triangles) {
+      if (code)
+         code += ", \n";
+      code += "     Triangle(";
+      code += t.a;
+      code += ", ";
+      code += t.aUV;
+      code += ", ";
+      code += t.b;
+      code += ", ";
+      code += t.bUV;
+      code += ", ";
+      code += t.c;
+      code += ", ";
+      code += t.cUV;
+      code += ", ";
+      code += t.n;
+      code += ")";
+   }
+   return code;
+}
+
+/// Serialize gathered triangles to a quantized GLSL array initializer        
+///   @param triangles - the triangles to serialize                           
+///   @param min - the minimum of the scene bounds                            
+///   @param extent - the size of the scene bounds                            
+///   @return the GLSL code                                                   
+static GLSL SerializePackedTriangles(const TMany<Scene::Triangle>& triangles, const Vec3& min, const Vec3& extent) {
+   const auto quantize = [&](const Vec3& p, Offset i) -> uint32_t {
+      return extent[i] > 0 ? PackUnorm16((p[i] - min[i]) / extent[i]) : 0;
+   };
+
+   const auto uint = [](uint32_t value) {
+      return Text {value, 'u'};
+   };
+
+   GLSL code;
+   for (auto& t : triangles) {
+      if (code)
+         code += ", \n";
+
+      const uint32_t positions[5] = {
+         quantize(t.a, 0) | (quantize(t.a, 1) << 16),
+         quantize(t.a, 2) | (quantize(t.b, 0) << 16),
+         quantize(t.b, 1) | (quantize(t.b, 2) << 16),
+         quantize(t.c, 0) | (quantize(t.c, 1) << 16),
+         quantize(t.c, 2)
+      };
+
+      code += "     PackedTriangle(uint[5](";
+      for (Offset i = 0; i < 5; ++i) {
+         code += uint(positions[i]);
+         if (i < 4)
+            code += ", ";
+      }
+      code += "), ";
+      code += uint(PackOctahedral(t.n));
+      code += ", uint[3](";
+      code += uint(PackHalf(t.aUV[0]) | (PackHalf(t.aUV[1]) << 16));
+      code += ", ";
+      code += uint(PackHalf(t.bUV[0]) | (PackHalf(t.bUV[1]) << 16));
+      code += ", ";
+      code += uint(PackHalf(t.cUV[0]) | (PackHalf(t.cUV[1]) << 16));
+      code += "))";
+   }
+   return code;
+}
+
+namespace {
+
+   /// A unique mesh in the scene, that might be shared by many instances     
+   struct SharedMesh {
+      const A::Mesh* mSource;
+      TMany<Scene::Triangle> mTriangles;
+      Offset mStart;
+   };
+
+} // anonymous namespace
+
+/// Check if two lists of triangles are identical                             
+///   @param lhs - left list                                                  
+///   @param rhs - right list                                                 
+///   @return true if both lists contain the exact same triangles             
+static bool SameTriangles(const TMany<Scene::Triangle>& lhs, const TMany<Scene::Triangle>& rhs) {
+   return lhs.GetCount() == rhs.GetCount() and 0 == ::std::memcmp(
+      lhs.GetRaw(), rhs.GetRaw(), lhs.GetCount() * sizeof(Scene::Triangle));
+}
+
+/// Gather the child scenes of a node, so that they can be merged             
+/// The first scene generates the code for all of them, so that no scene is   
+/// evaluated more than once                                                  
+///   @param parent - the node to search for scenes                           
+///   @param merged - [out] all scenes except the first one go here           
+///   @return the first child scene, or nullptr if there are no scenes        
+auto Scene::FromChildren(Node& parent, TMany<const Scene*>& merged) -> Scene* {
+   Scene* first = nullptr;
+   parent.ForEachChild([&](Scene& scene) {
+      if (not first)
+         first = &scene;
+      else
+         merged << &scene;
+   });
+   return first;
+}
+
+/// Get the number of instances generated along the triangles                 
+///   @return the number of instances, or zero if scene isn't instanced       
+auto Scene::GetInstanceCount() const noexcept -> Count {
+   return mInstanceCount;
+}
+
+/// Get the number of triangles in the largest instance                       
+///   @return the number of triangles, or zero if scene isn't instanced       
+auto Scene::GetInstanceTriangleCount() const noexcept -> Count {
+   return mInstanceTriangles;
 }
 
 /// Generate scene code                                                       
+/// Identical meshes are emitted only once, and referenced by a list of       
+/// instances, each with its own transformation. Other scenes can be merged   
+/// into this one, so that they all share a single triangle array, and each   
+/// scene gets its own range of instances                                     
+///   @param rate - the rate at which triangles are consumed, the node's own  
+///                 rate is used if Rate::Auto                                
+///   @param merged - other scenes to merge into this one                     
 ///   @return the array of triangles symbol                                   
-const Symbol& Scene::GenerateTriangles() {
-   GLSL triangles;
-   Count countCombined = 0;
+const Symbol& Scene::GenerateTriangles(RefreshRate rate, const TMany<const Scene*>& merged) {
+   // Triangles are generated on demand, in the stage that consumes     
+   // them, so the rate is overridden only for the duration of this call
+   const auto previousRate = mRate;
+   if (rate != Rate::Auto)
+      mRate = rate;
+
+   TMany<SharedMesh> meshes;
+   TMany<Mat4> instanceTransforms;
+   TMany<Offset> instanceMeshes;
+   bool transformed = false;
 
    // Get the triangles of each geometry construct                      
-   mDescriptor.ForEachConstruct([&](const Construct& c) {
+   const auto gather = [&](const Construct& c) {
       if (not c.CastsTo<A::Mesh>())
          return;
 
@@ -165,61 +740,149 @@ const Symbol& Scene::GenerateTriangles() {
       geometryDescriptor <<= MetaOf<Normal>();
       geometryDescriptor <<= MetaOf<Sampler2>();
 
+      // The instance transformation is applied in the shader, so it    
+      // isn't part of the geometry. This way identical meshes with     
+      // different transformations produce the same geometry asset      
+      Mat4 transform;
+      if (geometryDescriptor.GetDescriptor().ExtractTrait<Traits::Transform>(transform)) {
+         geometryDescriptor.GetDescriptor().template RemoveTrait<Traits::Transform>();
+         transformed = true;
+      }
+
       // Get the generated geometry asset                               
       Verbs::Create creator {geometryDescriptor};
       const auto geometry = mMaterial->RunIn(creator)->As<A::Mesh*>();
-      const auto count = geometry->GetTriangleCount();
-      for (Count i = 0; i < count; ++i) {
-         auto position = geometry->template GetTriangleTrait<Traits::Place>(i);
-         LANGULUS_ASSERT(position, Material,
-            "Can't rasterize a triangle without Traits::Place");
 
-         if (not position.template CastsTo<Vec3>(1))
-            TODO();
+      // Reuse an already gathered mesh, if the same asset was produced 
+      Offset shared = 0;
+      while (shared < meshes.GetCount() and meshes[shared].mSource != geometry)
+         ++shared;
 
-         auto normal = geometry->template GetTriangleTrait<Traits::Aim>(i);
-         LANGULUS_ASSERT(normal, Material,
-            "Can't rasterize a triangle without Traits::Aim");
+      if (shared == meshes.GetCount()) {
+         TMany<Triangle> triangles;
+         if (not GatherTrianglesBulk(*geometry, triangles))
+            GatherTrianglesSlow(*geometry, triangles);
 
-         if (not normal.template CastsTo<Vec3>(1))
-            TODO();
+         // Different assets might still produce identical triangles    
+         shared = 0;
+         while (shared < meshes.GetCount() and not SameTriangles(meshes[shared].mTriangles, triangles))
+            ++shared;
 
-         auto texture = geometry->GetTriangleTrait<Traits::Sampler>(i);
-         LANGULUS_ASSERT(texture, Material,
-            "Can't rasterize a triangle without Traits::Sampler");
-
-         if (not texture.template CastsTo<Vec2>(1))
-            TODO();
+         if (shared == meshes.GetCount())
+            meshes << SharedMesh {geometry, Move(triangles), 0};
+      }
 
-         if (countCombined > 0)
-            triangles += ", \n";
-         triangles += "     Triangle(";
-         triangles += position.As<Vec3>(0);
-         triangles += ", ";
-         triangles += texture.As<Vec2>(0);
-         triangles += ", ";
-         triangles += position.As<Vec3>(1);
-         triangles += ", ";
-         triangles += texture.As<Vec2>(1);
-         triangles += ", ";
-         triangles += position.As<Vec3>(2);
-         triangles += ", ";
-         triangles += texture.As<Vec2>(2);
-         triangles += ", ";
-         triangles += normal.As<Vec3>(0);
-         triangles += ")";
-         ++countCombined;
+      instanceTransforms << transform;
+      instanceMeshes << shared;
+   };
+
+   // Gather this scene and all merged ones into a single instance      
+   // list - merged scenes are always instanced, and rasterized as one  
+   this->mDescriptor.ForEachConstruct(gather);
+   for (auto source : merged)
+      source->mDescriptor.ForEachConstruct(gather);
+
+   LANGULUS_ASSERT(meshes, Material, "No triangles available");
+
+   // Simplify each unique mesh, if a budget or error threshold is set, 
+   // distributing the triangle budget proportionally                   
+   Count uniqueTriangles = 0;
+   for (auto& mesh : meshes)
+      uniqueTriangles += mesh.mTriangles.GetCount();
+
+   Decimator decimator {mTriangleBudget, mMaxError};
+   if (decimator.IsEnabled()) {
+      for (auto& mesh : meshes) {
+         if (mTriangleBudget) {
+            decimator.mBudget = ::std::max(Count {1},
+               mTriangleBudget * mesh.mTriangles.GetCount() / uniqueTriangles);
+         }
+         mesh.mTriangles = decimator.Simplify(mesh.mTriangles);
       }
-   });
+   }
 
-   LANGULUS_ASSERT(countCombined, Material, "No triangles available");
+   // Concatenate all unique meshes                                     
+   TMany<Triangle> gathered;
+   for (auto& mesh : meshes) {
+      mesh.mStart = gathered.GetCount();
+      gathered += mesh.mTriangles;
+   }
 
-   // Aggregate all triangles in an array:                              
-   // const Triangle cTriangles[N] = Triangle[N](                       
-   //      Triangle(a, aUV, b, bUV, c, cUV, n),                         
-   //      ... N times                                                  
-   //   );                                                              
    AddDefine("Triangle", TriangleStruct);
-   AddDefine("cTriangles", Text::TemplateRt(TriangleList, countCombined, triangles));
-   return ExposeData<Scene>("cTriangles");
+   Token fetch;
+   if (mCompressed) {
+      // Quantize positions relative to the scene bounds                
+      Vec3 min = gathered[0].a;
+      Vec3 max = gathered[0].a;
+      for (auto& t : gathered) {
+         for (Offset i = 0; i < 3; ++i) {
+            min[i] = ::std::min({min[i], t.a[i], t.b[i], t.c[i]});
+            max[i] = ::std::max({max[i], t.a[i], t.b[i], t.c[i]});
+         }
+      }
+
+      // Aggregate all triangles in a quantized array:                  
+      // const PackedTriangle cPackedTriangles[N] = PackedTriangle[N](  
+      //      PackedTriangle(uint[5](positions), normal, uint[3](uvs)), 
+      //      ... N times                                               
+      //   );                                                           
+      const Vec3 extent = max - min;
+      AddDefine("PackedTriangle", PackedTriangleStruct);
+      AddDefine("DecodeTriangle", Text::TemplateRt(DecodeTriangleFunction,
+         GLSL {min}, GLSL {extent / Real {65535}}));
+      AddDefine("cPackedTriangles", Text::TemplateRt(PackedTriangleList,
+         gathered.GetCount(), SerializePackedTriangles(gathered, min, extent)));
+      fetch = "DecodeTriangle(cPackedTriangles[{}])";
+   }
+   else {
+      // Aggregate all triangles in an array:                           
+      // const Triangle cTriangles[N] = Triangle[N](                    
+      //      Triangle(a, aUV, b, bUV, c, cUV, n),                      
+      //      ... N times                                               
+      //   );                                                           
+      AddDefine("cTriangles", Text::TemplateRt(TriangleList,
+         gathered.GetCount(), SerializeTriangles(gathered)));
+      fetch = "cTriangles[{}]";
+   }
+
+   // Instances are generated only if a mesh is shared, or transformed, 
+   // otherwise the triangles are used as they are                      
+   mInstanceCount = 0;
+   mInstanceTriangles = 0;
+   if (transformed or merged or meshes.GetCount() < instanceMeshes.GetCount()) {
+      // const Instance cInstances[M] = Instance[M](                    
+      //      Instance(transform, normal transform, start, count),      
+      //      ... M times                                               
+      //   );                                                           
+      GLSL instances;
+      for (Offset i = 0; i < instanceMeshes.GetCount(); ++i) {
+         const auto& mesh = meshes[instanceMeshes[i]];
+         if (instances)
+            instances += ", \n";
+         instances += "     Instance(";
+         instances += instanceTransforms[i];
+         instances += ", ";
+         instances += NormalTransform(instanceTransforms[i]);
+         instances += ", ";
+         instances += mesh.mStart;
+         instances += ", ";
+         instances += mesh.mTriangles.GetCount();
+         instances += ")";
+         mInstanceTriangles = ::std::max(mInstanceTriangles, mesh.mTriangles.GetCount());
+      }
+
+      mInstanceCount = instanceMeshes.GetCount();
+      AddDefine("Instance", InstanceStruct);
+      AddDefine("cInstances", Text::TemplateRt(InstanceList,
+         mInstanceCount, instances));
+      VERBOSE_NODE("Scene instanced: ", mInstanceCount, " instances of ",
+         meshes.GetCount(), " unique meshes");
+   }
+
+   // Expose the triangle fetch template, along with the number of      
+   // triangles available                                               
+   auto& symbol = ExposeData<Scene>(fetch, Traits::Index::OfType<int>());
+   symbol.mCount = gathered.GetCount();
+   mRate = previousRate;
+   return symbol;
 }
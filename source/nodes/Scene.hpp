@@ -22,12 +22,39 @@ namespace Nodes
       LANGULUS(ABSTRACT) false;
       LANGULUS_BASES(Node);
 
+      /// A triangle, gathered from a mesh in a flat, shader-ready form       
+      struct Triangle {
+         Vec3 a; Vec2 aUV;
+         Vec3 b; Vec2 bUV;
+         Vec3 c; Vec2 cUV;
+         Vec3 n;
+      };
+
+   private:
+      // Triangle budget for simplification, zero to disable            
+      Count mTriangleBudget {};
+      // Maximum simplification error, zero to disable                  
+      Real mMaxError {};
+      // Number of generated instances, zero if triangles aren't shared 
+      Count mInstanceCount {};
+      // Number of triangles in the largest instance                    
+      Count mInstanceTriangles {};
+      // Whether triangles are quantized to a compact encoding          
+      bool mCompressed {};
+
+   public:
       Scene(Describe&&);
 
       const Symbol& Generate();
-      const Symbol& GenerateSDF();
-      const Symbol& GenerateLines();
-      const Symbol& GenerateTriangles();
+      const Symbol& GenerateSDF(RefreshRate = Rate::Auto, const TMany<const Scene*>& = {});
+      const Symbol& GenerateIntersections(RefreshRate = Rate::Auto, const TMany<const Scene*>& = {});
+      const Symbol& GenerateLines(RefreshRate = Rate::Auto, const TMany<const Scene*>& = {});
+      const Symbol& GenerateTriangles(RefreshRate = Rate::Auto, const TMany<const Scene*>& = {});
+
+      static auto FromChildren(Node&, TMany<const Scene*>&) -> Scene*;
+
+      auto GetInstanceCount() const noexcept -> Count;
+      auto GetInstanceTriangleCount() const noexcept -> Count;
    };
 
 } // namespace Nodes
@@ -78,6 +105,46 @@ constexpr Token SDFUnionUsage = R"shader(
    )
 )shader";
 
+/// Domain repetition function                                                
+/// Folds space into a single cell, so that evaluating any number of repeated 
+/// elements costs as much as evaluating one of them                          
+///   @param {0} - name of the function                                       
+///   @param {1} - repetition period (vec3)                                   
+///   @param {2} - cell index computation                                     
+///   @param {3} - per-cell variation, can be empty                           
+///   @param {4} - the repeated scene element                                 
+constexpr Token SDFRepeatFunction = R"shader(
+   float {0}(in vec3 point) {{
+      const vec3 period = {1};
+      const vec3 cell = {2};
+      point -= period * cell;
+      {3}
+      return {4};
+   }}
+)shader";
+
+/// Infinite repetition cell index                                            
+///   @param {0} - reciprocal of the period, zero on axes that don't repeat   
+constexpr Token SDFRepeatCell = "round(point * {0})";
+
+/// Bounded repetition cell index                                             
+///   @param {0} - reciprocal of the period, zero on axes that don't repeat   
+///   @param {1} - the number of cells on each axis, minus one                
+constexpr Token SDFRepeatCellBounded = "clamp(round(point * {0}), vec3(0.0), {1})";
+
+/// Per-cell variation                                                        
+///   @param {0} - variation amplitude (vec3)                                 
+constexpr Token SDFRepeatVariation = "point -= (SDFHash3(cell) * 2.0 - 1.0) * {0};";
+
+/// Hash a cell index to three pseudo-random numbers in the [0; 1] range      
+constexpr Token SDFHash3 = R"shader(
+   vec3 SDFHash3(in vec3 cell) {
+      vec3 p = fract(cell * vec3(0.1031, 0.1030, 0.0973));
+      p += dot(p, p.yxz + 33.33);
+      return fract((p.xxy + p.yxx) * p.zyx);
+   }
+)shader";
+
 
 ///                                                                           
 /// Signed distance functions                                                 
@@ -85,82 +152,210 @@ constexpr Token SDFUnionUsage = R"shader(
 
 /// 3D box signed distance function                                           
 constexpr Token SDFBox3 = R"shader(
-   float SDF(in vec3 point, in Box3 box) {
-      const vec3 d = abs(point) - box.mOffsets;
+   float SDFBox3(in vec3 point, in vec3 size) {
+      const vec3 d = abs(point) - size;
       return length(max(d, 0.0)) + min(max(d.x, max(d.y, d.z)), 0.0);
-   };
-)shader";
-
-/// 2D box signed distance function                                           
-constexpr Token SDFBox2 = R"shader(
-   float SDF(in vec2 point, in Box2 box) {
-      const vec2 d = abs(point) - box.mOffsets;
-      return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0);
-   };
+   }
 )shader";
 
 /// 3D rounded box signed distance function                                   
 constexpr Token SDFBoxRounded3 = R"shader(
-   float SDF(in vec3 point, in BoxRounded3 box) {
-      const vec3 d = abs(point) - box.mOffsets;
-      return length(max(d, 0.0)) + min(max(d.x, max(d.y, d.z)), 0.0) - box.mRadius;
-   };
+   float SDFBoxRounded3(in vec3 point, in vec3 size, in float radius) {
+      const vec3 d = abs(point) - size;
+      return length(max(d, 0.0)) + min(max(d.x, max(d.y, d.z)), 0.0) - radius;
+   }
 )shader";
 
-/// 2D rounded box signed distance function                                   
-constexpr Token SDFBoxRounded2 = R"shader(
-   float SDF(in vec2 point, in BoxRounded2 box) {
-      const vec2 d = abs(point) - box.mOffsets;
-      return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0) - box.mRadius;
-   };
+/// Cone signed distance function, for a cone with its apex in the origin,    
+/// opening towards the negative side of its axis, and capped at its height   
+///   @param {0} - axis name (X, Y or Z)                                      
+///   @param {1} - swizzle of the cross-section plane (yz, xz or xy)          
+///   @param {2} - swizzle of the axis (x, y or z)                            
+constexpr Token SDFCone = R"shader(
+   float SDFCone{0}(in vec3 point, in float angle, in float height) {{
+      const float q = length(point.{1});
+      const vec2 c = vec2(sin(angle), cos(angle));
+      return max(dot(c, vec2(q, point.{2})), -height - point.{2});
+   }}
 )shader";
 
-/// Cone signed distance function (extends in X direction)                    
-constexpr Token SDFConeX = R"shader(
-   float SDF(in vec3 point, in ConeX cone) {
-      const float q = length(point.yz);
-      const vec2 c {sin(cone.mAngle), cos(cone.mAngle)};
-      return max(dot(c, vec2(q, point.x)), -cone.mHeight - point.x);
-   };
+/// Infinite cylinder signed distance function                                
+///   @param {0} - axis name (X, Y or Z)                                      
+///   @param {1} - swizzle of the cross-section plane (yz, xz or xy)          
+constexpr Token SDFCylinder = R"shader(
+   float SDFCylinder{0}(in vec3 point, in float radius) {{
+      return length(point.{1}) - radius;
+   }}
 )shader";
 
-/// Cone signed distance function (extends in Y direction)                    
-constexpr Token SDFConeY = R"shader(
-   float SDF(in vec3 point, in ConeY cone) {
-      const float q = length(point.xz);
-      const vec2 c {sin(cone.mAngle), cos(cone.mAngle)};
-      return max(dot(c, vec2(q, point.y)), -cone.mHeight - point.y);
-   };
+
+///                                                                           
+/// Ray intersection functions                                                
+/// Each returns the distance along the ray to the nearest hit, zero if the   
+/// ray starts inside the primitive, or a negative number on a miss           
+///                                                                           
+
+/// Scene intersection function, that picks the nearest hit of all elements   
+///   @param {0} - one NearestHit statement per element                       
+constexpr Token IntersectFunction = R"shader(
+   float Intersect(in vec3 origin, in vec3 direction) {{
+      float t = -1.0;
+      {0}
+      return t;
+   }}
 )shader";
 
-/// Cone signed distance function (extends in Z direction)                    
-constexpr Token SDFConeZ = R"shader(
-   float SDF(in vec3 point, in ConeZ cone) {
-      const float q = length(point.xy);
-      const vec2 c {sin(cone.mAngle), cos(cone.mAngle)};
-      return max(dot(c, vec2(q, point.z)), -cone.mHeight - point.z);
-   };
+/// Pick the nearer of two hits, ignoring misses                              
+constexpr Token IntersectNearest = R"shader(
+   float NearestHit(in float a, in float b) {
+      if (a < 0.0)
+         return b;
+      if (b < 0.0)
+         return a;
+      return min(a, b);
+   }
 )shader";
 
-/// Cylinder signed distance function (extends in X direction)                
-constexpr Token SDFCylinderX = R"shader(
-   float SDF(in vec3 point, in CylinderX cyl) {
-      return length(point.yz) - cyl.mRadius;
-   };
+/// Ray-box intersection, using the slab method                               
+constexpr Token IntersectBox3 = R"shader(
+   float IntersectBox3(in vec3 origin, in vec3 direction, in vec3 size) {
+      const vec3 m = 1.0 / direction;
+      const vec3 n = m * origin;
+      const vec3 k = abs(m) * size;
+      const vec3 t1 = -n - k;
+      const vec3 t2 = -n + k;
+      const float tN = max(max(t1.x, t1.y), t1.z);
+      const float tF = min(min(t2.x, t2.y), t2.z);
+      if (tN > tF || tF < 0.0)
+         return -1.0;
+      return max(tN, 0.0);
+   }
 )shader";
 
-/// Cylinder signed distance function (extends in Y direction)                
-constexpr Token SDFCylinderY = R"shader(
-   float SDF(in vec3 point, in CylinderY cyl) {
-      return length(point.xz) - cyl.mRadius;
-   };
+/// Ray-rounded box intersection                                              
+/// Based on Inigo Quilez's rounded box intersector, the bounding box is hit  
+/// first, and then the corner spheres and edge cylinders are tested          
+constexpr Token IntersectBoxRounded3 = R"shader(
+   float IntersectBoxRounded3(in vec3 origin, in vec3 direction, in vec3 size, in float radius) {
+      const vec3 m = 1.0 / direction;
+      const vec3 n = m * origin;
+      const vec3 k = abs(m) * (size + radius);
+      const vec3 t1 = -n - k;
+      const vec3 t2 = -n + k;
+      const float tN = max(max(t1.x, t1.y), t1.z);
+      const float tF = min(min(t2.x, t2.y), t2.z);
+      if (tN > tF || tF < 0.0)
+         return -1.0;
+      if (tN < 0.0) {
+         const vec3 q = abs(origin) - size;
+         if (length(max(q, 0.0)) + min(max(q.x, max(q.y, q.z)), 0.0) < radius)
+            return 0.0;
+      }
+
+      // Flip to the first octant, and check if a face was hit
+      float t = max(tN, 0.0);
+      const vec3 s = sign(origin + direction * t);
+      const vec3 ro = origin * s;
+      const vec3 rd = direction * s;
+      vec3 pos = ro + rd * t - size;
+      pos = max(pos.xyz, pos.yzx);
+      if (min(min(pos.x, pos.y), pos.z) < 0.0)
+         return t;
+
+      const vec3 oc = ro - size;
+      const vec3 dd = rd * rd;
+      const vec3 oo = oc * oc;
+      const vec3 od = oc * rd;
+      const float ra2 = radius * radius;
+      t = 1e20;
+
+      // Corner sphere
+      float b = od.x + od.y + od.z;
+      float c = oo.x + oo.y + oo.z - ra2;
+      float h = b * b - c;
+      if (h > 0.0)
+         t = -b - sqrt(h);
+
+      // Edge cylinders along each axis
+      for (int i = 0; i < 3; i++) {
+         const int j = (i + 1) % 3;
+         const int l = (i + 2) % 3;
+         const float a = dd[j] + dd[l];
+         b = od[j] + od[l];
+         c = oo[j] + oo[l] - ra2;
+         h = b * b - a * c;
+         if (h > 0.0) {
+            h = (-b - sqrt(h)) / a;
+            if (h > 0.0 && h < t && abs(ro[i] + rd[i] * h) < size[i])
+               t = h;
+         }
+      }
+
+      return t > 1e19 ? -1.0 : t;
+   }
 )shader";
 
-/// Cylinder signed distance function (extends in Z direction)                
-constexpr Token SDFCylinderZ = R"shader(
-   float SDF(in vec3 point, in CylinderZ cyl) {
-      return length(point.xy) - cyl.mRadius;
-   };
+/// Ray-cone intersection, for a cone with its apex in the origin, opening    
+/// towards the negative side of its axis, and capped at its height           
+///   @param {0} - axis name (X, Y or Z)                                      
+///   @param {1} - swizzle of the cross-section plane (yz, xz or xy)          
+///   @param {2} - swizzle of the axis (x, y or z)                            
+constexpr Token IntersectCone = R"shader(
+   float IntersectCone{0}(in vec3 origin, in vec3 direction, in float angle, in float height) {{
+      const float s = sin(angle);
+      const float k = cos(angle);
+      const vec2 q = origin.{1};
+      const vec2 v = direction.{1};
+      const float y = origin.{2};
+      const float dy = direction.{2};
+      if (s * length(q) + k * y <= 0.0 && y >= -height)
+         return 0.0;
+
+      // Lateral surface, only the half below the apex
+      float t = -1.0;
+      const float a = s * s * dot(v, v) - k * k * dy * dy;
+      const float b = s * s * dot(q, v) - k * k * y * dy;
+      const float c = s * s * dot(q, q) - k * k * y * y;
+      const float h = b * b - a * c;
+      if (h >= 0.0 && abs(a) > 1e-8) {{
+         const float roots[2] = float[2]((-b - sqrt(h)) / a, (-b + sqrt(h)) / a);
+         for (int i = 0; i < 2; i++) {{
+            const float hy = y + dy * roots[i];
+            if (roots[i] > 0.0 && hy <= 0.0 && hy >= -height)
+               t = NearestHit(t, roots[i]);
+         }}
+      }}
+
+      // Base cap
+      if (abs(dy) > 1e-8) {{
+         const float root = (-height - y) / dy;
+         const vec2 p = q + v * root;
+         const float radius = height * k / s;
+         if (root > 0.0 && dot(p, p) <= radius * radius)
+            t = NearestHit(t, root);
+      }}
+      return t;
+   }}
+)shader";
+
+/// Ray-infinite cylinder intersection                                        
+///   @param {0} - axis name (X, Y or Z)                                      
+///   @param {1} - swizzle of the cross-section plane (yz, xz or xy)          
+constexpr Token IntersectCylinder = R"shader(
+   float IntersectCylinder{0}(in vec3 origin, in vec3 direction, in float radius) {{
+      const vec2 q = origin.{1};
+      const vec2 v = direction.{1};
+      const float a = dot(v, v);
+      const float b = dot(q, v);
+      const float c = dot(q, q) - radius * radius;
+      if (c <= 0.0)
+         return 0.0;
+      const float h = b * b - a * c;
+      if (h < 0.0 || a < 1e-8)
+         return -1.0;
+      const float tN = (-b - sqrt(h)) / a;
+      return tN < 0.0 ? -1.0 : tN;
+   }}
 )shader";
 
 
@@ -184,3 +379,73 @@ constexpr Token TriangleStruct = R"shader(
 constexpr Token TriangleList = R"shader(
    const Triangle cTriangles[{0}] = Triangle[{0}]({1});
 )shader";
+
+/// Quantized triangle structure                                              
+/// Positions are 16-bit fixed point, relative to the scene bounds, the       
+/// normal is octahedral-encoded in two 16-bit snorms, and texture            
+/// coordinates are half floats. Takes 36 bytes instead of the 100 bytes      
+/// of a full precision Triangle                                              
+constexpr Token PackedTriangleStruct = R"shader(
+   struct PackedTriangle {
+      uint mPosition[5];
+      uint mNormal;
+      uint mUV[3];
+   };
+)shader";
+
+/// Quantized triangle array                                                  
+///   @param {0} number of triangles                                          
+///   @param {1] list of packed triangles                                     
+constexpr Token PackedTriangleList = R"shader(
+   const PackedTriangle cPackedTriangles[{0}] = PackedTriangle[{0}]({1});
+)shader";
+
+/// Quantized triangle decoder                                                
+///   @param {0} - scene bounds minimum (vec3)                                
+///   @param {1} - scene bounds extent, divided by 65535 (vec3)               
+constexpr Token DecodeTriangleFunction = R"shader(
+   vec3 DecodeOctahedral(in uint packed) {{
+      const vec2 o = unpackSnorm2x16(packed);
+      vec3 n = vec3(o, 1.0 - abs(o.x) - abs(o.y));
+      const float t = max(-n.z, 0.0);
+      n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+      return normalize(n);
+   }}
+
+   Triangle DecodeTriangle(in PackedTriangle packed) {{
+      const vec2 p0 = vec2(packed.mPosition[0] & 0xFFFFu, packed.mPosition[0] >> 16);
+      const vec2 p1 = vec2(packed.mPosition[1] & 0xFFFFu, packed.mPosition[1] >> 16);
+      const vec2 p2 = vec2(packed.mPosition[2] & 0xFFFFu, packed.mPosition[2] >> 16);
+      const vec2 p3 = vec2(packed.mPosition[3] & 0xFFFFu, packed.mPosition[3] >> 16);
+      const float p4 = float(packed.mPosition[4] & 0xFFFFu);
+
+      Triangle result;
+      result.a = {0} + vec3(p0.x, p0.y, p1.x) * {1};
+      result.b = {0} + vec3(p1.y, p2.x, p2.y) * {1};
+      result.c = {0} + vec3(p3.x, p3.y, p4) * {1};
+      result.aUV = unpackHalf2x16(packed.mUV[0]);
+      result.bUV = unpackHalf2x16(packed.mUV[1]);
+      result.cUV = unpackHalf2x16(packed.mUV[2]);
+      result.n = DecodeOctahedral(packed.mNormal);
+      return result;
+   }}
+)shader";
+
+/// Instance structure - a transformation applied to a range of triangles     
+/// The normal transformation is the inverse transpose of the model one,      
+/// computed once per instance on the CPU                                     
+constexpr Token InstanceStruct = R"shader(
+   struct Instance {
+      mat4 mTransform;
+      mat3 mNormalTransform;
+      int mStart;
+      int mCount;
+   };
+)shader";
+
+/// Instance array                                                            
+///   @param {0} number of instances                                          
+///   @param {1] list of instances                                            
+constexpr Token InstanceList = R"shader(
+   const Instance cInstances[{0}] = Instance[{0}]({1});
+)shader";
@@ -8,8 +8,10 @@
 #include "Texture.hpp"
 #include "../Material.hpp"
 #include "../MaterialLibrary.hpp"
+#include "../ImageFile.hpp"
 #include <Langulus/Image.hpp>
-#include <Langulus/IO.hpp>
+#include <algorithm>
+#include <chrono>
 
 using namespace Nodes;
 
@@ -29,17 +31,13 @@ Texture::Texture(Describe describe)
 
    // Extract Traits::File, if any                                      
    Many file; mDescriptor.ExtractTrait<Traits::Path>(file);
-   if (file) {
-      mTexture = CreateTexture(file);
-      VERBOSE_NODE("Texture generator changed to: ", mTexture);
-   }
+   if (file)
+      ReadTexture(file);
    
    // Create texture generators from sub-constructs                     
    mDescriptor.ForEachConstruct([&](const Construct& c) {
-      if (c.CastsTo<A::Image>() or c.CastsTo<A::File>()) {
-         mTexture = CreateTexture(c);
-         VERBOSE_NODE("Texture generator changed to: ", mTexture);
-      }
+      if (c.CastsTo<A::Image>() or c.CastsTo<A::File>())
+         CreateTexture(c);
       else Logger::Warning(Self(), "Ignored construct: ", c);
    });
    
@@ -47,13 +45,13 @@ Texture::Texture(Describe describe)
    mDescriptor.ForEachTail([&](const Many& data) {
       if (data.CastsTo<A::Image>()) {
          // Reuse a texture generator directly                          
-         mTexture = data.As<A::Image*>();
-         VERBOSE_NODE("Texture generator changed to: ", mTexture);
+         mKeyframes << Ref<A::Image> {data.As<A::Image*>()};
+         mFormats << mKeyframes.Last()->GetFormat();
+         VERBOSE_NODE("Texture keyframe added: ", mKeyframes.Last());
       }
       else if (data.CastsTo<Text>() and not data.CastsTo<Code>()) {
          // Any other text is considered a texture filename             
-         mTexture = CreateTexture(data.As<Text>());
-         VERBOSE_NODE("Texture generator changed to: ", mTexture);
+         ReadTexture(data);
       }
       else if (data.CastsTo<A::Number>()) {
          // Set texture id                                              
@@ -62,33 +60,145 @@ Texture::Texture(Describe describe)
       }
       else Logger::Warning(Self(), "Ignored data: ", data);
    });
+
+   // Extract the binding strategy                                      
+   Text strategy;
+   if (mDescriptor.ExtractTrait<Traits::Strategy>(strategy)) {
+      if (strategy == "Atlas")
+         mAtlas = true;
+      else
+         LANGULUS_THROW(Material, "Unknown texture strategy");
+   }
+
+   // Extract keyframe times, if any - keyframes are a second apart     
+   // by default                                                           
+   mDescriptor.ExtractTrait<Traits::Time>(mTimes);
+   if (not mTimes) {
+      for (Offset i = 0; i < mKeyframes.GetCount(); ++i)
+         mTimes << static_cast<Real>(i);
+   }
+
+   LANGULUS_ASSERT(mTimes.GetCount() == mKeyframes.GetCount(), Material,
+      "Texture keyframe times don't match the number of keyframes");
 }
 
 /// Release all external resources to avoid circular dependencies             
 void Texture::Detach() {
+   if (mPacked) {
+      GetLibrary()->GetAtlas().Release(mKeyframes[0]);
+      mPacked = false;
+   }
+
+   // Images, that aren't created yet, are abandoned - wait for any file
+   // reads in progress, before releasing the readers they use          
+   for (auto& pending : mPending) {
+      if (pending.mRead.valid())
+         pending.mRead.wait();
+   }
+   mPending.clear();
    mKeyframes.Reset();
-   mTexture.Reset();
    Node::Detach();
 }
 
-/// Create a texture from the provided descriptor                             
+/// Start creating a texture from the provided descriptor, without waiting    
+/// for it. The image is created when attached, while the keyframe stays      
+/// empty until then                                                          
 ///   @param descriptor - the descriptor for the texture                      
-///   @return the produced texture                                            
-auto Texture::CreateTexture(const Many& descriptor) -> Ref<A::Image> {
+void Texture::CreateTexture(const Many& descriptor) {
    auto local = Construct::From<A::Image>(descriptor);
    local << Traits::Parent {this}; // Ref {this}
-   Verbs::Create creator {&local};
-   return GetMaterial()->RunIn(creator)->As<A::Image*>();
+
+   mKeyframes << Ref<A::Image> {};
+   mFormats << DMeta {};
+   mPending.push_back({mKeyframes.GetCount() - 1, Move(local)});
+   VERBOSE_NODE("Texture keyframe requested: ", mPending.back().mDescriptor);
 }
 
-/// Assembles a GLSL texture(...) function                                    
-///   @param sampler - sampler token                                          
-///   @param uv - texture coordinates                                         
+/// Start reading a texture file, without waiting for it. The file is         
+/// opened through the framework file system, so that its path resolves       
+/// like any other asset's, and its header is probed for the pixel format     
+/// right away. The rest of the file is read on another thread, into a        
+/// buffer allocated here. The image itself is created on this thread, when   
+/// attached, because creating runs verbs in the module hierarchy, which      
+/// isn't thread-safe                                                         
+///   @param path - the file path                                             
+void Texture::ReadTexture(const Many& path) {
+   auto fileConstruct = Construct::From<A::File>(path);
+   Verbs::Create fileCreator {&fileConstruct};
+   Ref<A::File> file;
+   if (auto created = mMaterial->RunIn(fileCreator))
+      file = created->As<A::File*>();
+   LANGULUS_ASSERT(file and file->Exists(), Material,
+      "Texture file doesn't exist", path);
+
+   // Probe the header, and the chunks that follow it, in advance, so   
+   // that generating code doesn't have to wait for the image           
+   TMany<Byte> header;
+   header.New(::std::min(ProbeSize, file->GetBytes()));
+   file->NewReader()->Read(header);
+   const auto format = ProbeImageFormat(header.GetRaw(), header.GetCount());
+
+   auto local = Construct::From<A::Image>(path);
+   local << Traits::Parent {this}; // Ref {this}
+
+   mKeyframes << Ref<A::Image> {};
+   mFormats << format;
+   auto& pending = mPending.emplace_back(
+      mKeyframes.GetCount() - 1, Move(local), file->NewReader());
+   pending.mContents.New(file->GetBytes());
+   pending.mRead = ::std::async(::std::launch::async, [&pending] {
+      pending.mReader->Read(pending.mContents);
+   });
+   VERBOSE_NODE("Texture keyframe requested: ", pending.mDescriptor,
+      ", probed as ", format);
+}
+
+/// Create the images, whose files have finished reading, and attach them to  
+/// their keyframes. The material polls this on refresh, so images attach     
+/// as soon as they're read, even if nothing waits for them                   
+///   @param wait - whether to block until all images are created             
+///   @return true if there are no pending images anymore                     
+bool Texture::Attach(bool wait) {
+   ::std::erase_if(mPending, [&](Pending& pending) {
+      if (pending.mRead.valid()) {
+         if (not wait and pending.mRead.wait_for(::std::chrono::seconds {0})
+                       != ::std::future_status::ready)
+            return false;
+
+         // Decode the contents, that are already in memory, instead of 
+         // reading the file again                                      
+         pending.mRead.get();
+         pending.mReader.Reset();
+         pending.mDescriptor << Move(pending.mContents);
+      }
+
+      Verbs::Create creator {&pending.mDescriptor};
+      auto& keyframe = mKeyframes[pending.mKeyframe];
+      keyframe = mMaterial->RunIn(creator)->As<A::Image*>();
+      VERBOSE_NODE("Texture keyframe attached: ", keyframe);
+
+      // Code might have been generated for the probed format already,  
+      // so the decoder must agree with the probe                       
+      auto& format = mFormats[pending.mKeyframe];
+      const auto decoded = keyframe->GetFormat();
+      if (format and format != decoded) {
+         LANGULUS_ASSERT(not mGenerated, Material,
+            "Decoded texture format doesn't match the probed one: ",
+            decoded, " instead of ", format);
+         VERBOSE_NODE("Texture format corrected to: ", decoded);
+      }
+      format = decoded;
+      return true;
+   });
+   return mPending.empty();
+}
+
+/// Spread the channels of a texture fetch to all four components             
+///   @param pixel - the texture fetch                                        
 ///   @param result - the resulting color format                              
-///   @return generated texture call                                          
-auto GetPixel(const GLSL& sampler, const GLSL& uv, DMeta result) -> GLSL {
+///   @return the swizzled fetch                                              
+auto SwizzlePixel(const GLSL& pixel, DMeta result) -> GLSL {
    LANGULUS_ASSERT(result, Material, "Unknown texture format");
-   const auto pixel = Text::TemplateRt(GetPixelFunction, sampler, uv);
    switch (result->GetMemberCount()) {
    case 1:           return pixel + ".rrrr";
    case 2:           return pixel + ".rgrg";
@@ -97,219 +207,185 @@ auto GetPixel(const GLSL& sampler, const GLSL& uv, DMeta result) -> GLSL {
    }
 }
 
-/// Turn a keyframe and all of its dependencies to GLSL code                  
-///   @param frameMap - the texture channel keyframes                         
-///   @param keyIdx - the index of the keyframe                               
-///   @param uv - the texture coordinate symbol                               
-///   @return the generated GLSL code                                         
-auto Texture::GenerateKeyframe(const Temporal&) -> GLSL {
-   GLSL symbol;
-
-   // Scan the keyframe verb                                            
-   /*bool usingChannelId {};
-   Offset channelId {};
-   keyframe.ForEachDeep([&](const Block& group) {
-      group.ForEach(
-         [&](const Real& id) {
-            // Get a channel ID                                         
-            usingChannelId = true;
-            channelId = static_cast<Offset>(id);
-         },
-         [&](const Code& code) {
-            // Generate keyframe from GASM code                         
-            auto uvNode = Nodes::Value::Local(
-               this, Trait::From<Traits::Sampler, Vec2>(), mRate, 
-               uv.IsEmpty() ? GetTextureCoordinates() : uv
-            );
-            uvNode.DoGASM(code);
-            symbol = uvNode.GetOutputSymbolAs(MetaData::Of<Vec4f>(), 0);
-         },
-         [&](const RGBA& color) {
-            // Generate keyframe from a static color                    
-            symbol += color;
-         },
-         [&](const Construct& construct) {
-            bool relevantConstruct = false;
-            if (construct.CastsTo<A::File>()) {
-               // Generate keyframe from a texture file                 
-               Verbs::Create creator {&construct};
-               Many environment = mProducer->GetOwners();
-               Verb::ExecuteVerb(environment, creator);
-               creator->ForEachDeep([&](A::Texture* t) {
-                  t->Generate();
-                  auto uniform = GetProducer()->AddInput(Rate::Auto, Trait::From<Traits::Texture>(t), true);
-                  symbol = GetPixel(
-                     uniform,
-                     uv.IsEmpty() ? GetTextureCoordinates() : uv,
-                     t->GetFormat()
-                  );
-                  relevantConstruct = true;
-               });
-            }
-            else {
-               //TODO support other kinds of constructs?
-               TODO();
-            }
-
-            LANGULUS_ASSERT(relevantConstruct, Material, "Irrelevant keyframe construct");
-         }
-      );
-   });
+/// Assembles a GLSL texture(...) function                                    
+///   @param sampler - sampler token                                          
+///   @param uv - texture coordinates                                         
+///   @param result - the resulting color format                              
+///   @param grad - texture coordinate derivatives, if known                  
+///   @return generated texture call                                          
+auto GetPixel(const GLSL& sampler, const GLSL& uv, DMeta result, const GLSL& grad = {}) -> GLSL {
+   const auto pixel = grad
+      ? Text::TemplateRt(GetPixelGradFunction, sampler, uv, grad)
+      : Text::TemplateRt(GetPixelFunction, sampler, uv);
+   return SwizzlePixel(pixel, result);
+}
+
+/// Get the pixel format of the keyframes                                     
+///   @return the format, that all keyframes must share                       
+auto Texture::GetFormat() -> DMeta {
+   LANGULUS_ASSERT(mKeyframes, Material, "No texture keyframes");
 
-   // Fallback for when only channel ID is available                    
-   if (symbol.IsEmpty() && usingChannelId) {
-      const auto texture = GetValue<Traits::Texture>();
-      const auto& trait = texture.GetOutputTrait();
-      symbol = GetPixel(
-         texture.GetOutputSymbol(), 
-         uv.IsEmpty() ? GetTextureCoordinates() : uv, 
-         trait.GetMeta()
-      );
-   }*/
-
-   LANGULUS_ASSERT(symbol, Material, "Bad keyframe symbol");
-   return symbol;
+   // Wait for the images only if some formats weren't probed           
+   for (auto format : mFormats) {
+      if (not format) {
+         Attach(true);
+         break;
+      }
+   }
+
+   DMeta result {};
+   for (Offset i = 0; i < mKeyframes.GetCount(); ++i) {
+      const auto format = mFormats[i];
+      LANGULUS_ASSERT(not result or format == result, Material,
+         "Texture keyframes must share the same format", format);
+      result = format;
+   }
+   return result;
 }
 
-/// Generate sampler definitions                                              
-///   @param frameMap - the keyframe map to generate                          
-///   @param uv - the texture coordinate symbol                               
-///   @return the generated GLSL code                                         
-/*GLSL Texture::GenerateDefinition(KeyframeMap* frameMap, const GLSL& uv) {
-   if (frameMap->IsEmpty())
-      return {};
-
-   const GLSL functionId = pcToHex(frameMap);
-   if (frameMap->GetCount() == 1) {
-      // A single keyframe just returns itself                          
-      return GetKeyframe(frameMap, 0, uv);
+/// Pack the single keyframe in the shared atlas, if requested and if the     
+/// image is small enough                                                     
+///   @param format - the pixel format                                        
+///   @param uv - texture coordinates, or a template for them                 
+///   @param grad - derivatives of the coordinates, if known                  
+///   @return the texture function, or nullptr if not packed                  
+auto Texture::GenerateAtlased(DMeta format, const GLSL& uv, const GLSL& grad) -> const Symbol* {
+   if (not mAtlas)
+      return nullptr;
+
+   // The image size is required for packing, so wait for the image     
+   Attach(true);
+   auto& image = mKeyframes[0];
+   const auto& view = image->GetView();
+   auto& atlas = GetLibrary()->GetAtlas();
+   if (not atlas.Accepts(view.mWidth, view.mHeight)) {
+      VERBOSE_NODE("Image too large for the atlas: ", image);
+      return nullptr;
    }
 
-   // Number of keyframes available                                     
-   const auto count = frameMap->GetCount();
-   const auto animationStart = frameMap->GetKey(0).SecondsReal();
-
-   // The animate function picks the keyframes depending on time        
-   GLSL definition = 
-      "vec4 AnimateTextures_"_glsl + functionId + "(in float time, in vec2 uv) {\n"
-      "   if (time <= " + animationStart + ") {\n"
-      "      // Time before/at start returns first keyframe\n"
-      "      return " + GetKeyframe(frameMap, 0, "uv") + ";\n"
-      "   }\n";
-
-   // Since samplers can't be saved to a variable, we have to explictly 
-   // generate an if statement for each inter-keyframe situation :(     
-   for (Offset i = 1; i < count; ++i) {
-      const auto frameStart = frameMap->Keys()[i-1].SecondsReal();
-      const auto frameEnd = frameMap->Keys()[i].SecondsReal();
-      const auto frameLength = frameEnd - frameStart;
-      const auto textureStart = GetKeyframe(frameMap, i - 1, "uv");
-      const auto textureEnd = GetKeyframe(frameMap, i, "uv");
-
-      if (textureStart == textureEnd) {
-         // No need to mix textures                                     
-         definition += 
-            "   else if (time < "_glsl + frameEnd + ") {\n"
-            "      return " + textureStart + ";\n"
-            "   }\n";
-      }
-      else {
-         // Need to mix two textures                                    
-         definition += 
-            "   else if (time < "_glsl + frameEnd + ") {\n"
-            "      const float ratio = (time - " + frameStart + ") / " + frameLength + ";\n"
-            "      return mix(" + textureStart + ", " + textureEnd + ", ratio);"
-            "   }\n";
-      }
+   // Pack only once, because each packing counts as another user       
+   if (not mPacked) {
+      mRegion = atlas.Pack(image, view.mWidth, view.mHeight);
+      mPacked = true;
    }
 
-   definition +=
-      "   else {\n"
-      "      // Time at/after last keyframe returns last keyframe\n"
-      "      return " + GetKeyframe(frameMap, count-1, "uv") + ";\n"
-      "   }\n"
-      "}\n\n";
+   const auto& region = mRegion;
+   const auto sampler = mMaterial->AddAtlas(region.mPage, atlas.GetMipCount());
+   VERBOSE_NODE("Packed in atlas page ", region.mPage, " at ",
+      region.mX, ':', region.mY);
 
-   // Commit the animation function                                     
-   Commit(ShaderToken::Functions, definition);
+   const Text id {sampler, '_', region.mX, '_', region.mY};
+   AddDefine(Text {"Atlas", id}, Text::TemplateRt(AtlasFunction, id, sampler,
+      GLSL {region.mScale}, GLSL {region.mOffset}, atlas.mPageSize,
+      static_cast<Real>(Count {1} << (atlas.GetMipCount() - 1))));
 
-   // And return its usage                                              
-   return "AnimateTextures_"_glsl + functionId + "(time, " 
-      + (uv.IsEmpty() ? GetTextureCoordinates() : uv) + ")";
-}*/
+   const auto fetch = grad
+      ? GLSL {"Atlas", id, '(', uv, ", ", grad, ')'}
+      : GLSL {"Atlas", id, "({})"};
+   return &ExposePixel(SwizzlePixel(fetch, format), grad);
+}
+
+/// Expose the texture fetch                                                  
+///   @param code - the texture fetch code                                    
+///   @param grad - the derivatives, if the fetch is bound to the coordinates 
+///                 they are known for, instead of accepting any              
+///   @return the texture symbol                                              
+auto Texture::ExposePixel(const GLSL& code, const GLSL& grad) -> const Symbol& {
+   if (grad)
+      return ExposeData<Vec4>(code);
+   return ExposeData<Vec4>(code, Traits::Sampler::OfType<Vec2>());
+}
+
+/// Use a function of texture coordinates, generated by a child node, such    
+/// as an FBM, as the texture                                                 
+///   @param generator - the child's function template                        
+///   @return the texture function, that accepts texture coordinates          
+auto Texture::GenerateFromSymbol(const Symbol& generator) -> const Symbol& {
+   const auto type = generator.mTrait.GetType();
+   LANGULUS_ASSERT(type, Material, "Texture generator has no type");
+
+   // Scalars are broadcast to all channels, like greyscale images      
+   GLSL pixel;
+   if (type->template CastsTo<A::Number>(1))
+      pixel = GLSL {"vec4(", generator.mCode, ")"};
+   else if (type->template CastsTo<A::Number>(4))
+      pixel = generator.mCode;
+   else
+      LANGULUS_THROW(Material, "Unsupported texture generator");
+
+   VERBOSE_NODE("Texture generated by: ", generator.mCode);
+   return ExposeData<Vec4>(pixel, Traits::Sampler::OfType<Vec2>());
+}
 
 /// Generate the shader stages                                                
+///   @return the texture function, that accepts texture coordinates          
 auto Texture::Generate() -> const Symbol& {
-   Descend();
-
-   /*Count totalKeyframeCount {};
-   totalKeyframeCount += mKeyframesGlobal.GetCount();
-   for (auto& channel : mKeyframes)
-      totalKeyframeCount += channel.GetCount();
-
-   if (totalKeyframeCount == 1) {
-      // If total count of keyframes is 1, just return the keyframe     
-      // There's no need of mixing functions                            
-      // Also, uv symbol is passed empty, because it will be requested  
-      // only on demand - we might not require it at all                
-      GLSL code;
-      for (auto& channel : mKeyframes)
-         code += GenerateDefinition(&channel, "");
-      code += GenerateDefinition(&mKeyframesGlobal, "");
-
-      Commit(ShaderToken::Texturize, "vec4 texturized = " + code + ";\n");
-      Expose<Traits::Color, Vec4>("texturized");
-      return;
+   // Generate children first, remembering the first function among     
+   // them, in case there are no keyframes to sample                    
+   mGenerated = true;
+   const Symbol* generator {};
+   for (auto child : mChildren) {
+      const auto& symbol = child->Generate();
+      if (not generator and symbol.mArguments)
+         generator = &symbol;
    }
 
-   // If this is reached, then we have a complex scenario of multiple   
-   // channels and/or keyframes                                         
-   // Combine all these in a single Texturize() function                
-   const bool hasGlobalKeyframes = !mKeyframesGlobal.IsEmpty();
-   GLSL texturize = "vec4 Texturize(int id, in vec2 uv) {\n";
-   if (hasGlobalKeyframes)
-      texturize += "   vec4 temporary = " + GenerateDefinition(&mKeyframesGlobal, "uv") + ";\n";
-
-   for (Offset i = 0; i < mKeyframes.GetCount(); ++i) {
-      // Generate a branch for each channel                             
-      const auto& id = mKeyframes.GetKey(i);
-      if (id != mKeyframes.Keys()[0])
-         texturize += "   else \n";
-
-      if (id != mKeyframes.Keys().Last())
-         texturize += "   if (id == "_glsl + id + ")\n";
+   if (not mKeyframes and generator)
+      return GenerateFromSymbol(*generator);
+
+   Attach(false);
+   const auto format = GetFormat();
+
+   // Sample with analytic derivatives, when a node, such as a          
+   // per-pixel Raster, provides them along with their coordinates,     
+   // because implicit derivatives break at triangle edges. They are    
+   // valid only for those exact coordinates, so the fetch is bound to  
+   // them, instead of accepting arbitrary ones                         
+   GLSL uv = "{}";
+   GLSL grad;
+   auto symGrad = GetSymbol<Traits::Derivative, Vec4>();
+   auto symUV = GetSymbol<Traits::Sampler, Vec2>();
+   if (symGrad and symUV) {
+      uv = symUV->mCode;
+      grad = symGrad->mCode;
+   }
 
-      if (hasGlobalKeyframes)
-         texturize += "      temporary += ";
-      else
-         texturize += "      return ";
+   if (mKeyframes.GetCount() == 1) {
+      if (auto atlased = GenerateAtlased(format, uv, grad))
+         return *atlased;
 
-      texturize += GenerateDefinition(&mKeyframes.GetValue(i), "uv") + ";\n";
+      // A single keyframe is just a texture fetch                      
+      const auto sampler = mMaterial->AddInput(Rate::Renderable,
+         Traits::Image::OfType<A::Image>(), true);
+      return ExposePixel(GetPixel(sampler, uv, format, grad), grad);
    }
 
-   // Close up the function                                             
-   if (hasGlobalKeyframes)
-      texturize += "   return temporary;\n";
-   texturize += "}\n\n";
+   // Multiple keyframes are bound together as layers of a single       
+   // array sampler, so any two of them can be picked by index          
+   const auto sampler = mMaterial->AddInput(Rate::Renderable,
+      Traits::Image::OfType<TMany<A::Image*>>(), true);
+   auto symTime = GetSymbol<Traits::Time, Real>(Rate::Tick);
+   LANGULUS_ASSERT(symTime, Material, "Texture animation requires time");
+
+   Text times;
+   for (auto& time : mTimes) {
+      if (&time != &mTimes[0])
+         times += ", ";
+      times += Text {time};
+   }
 
-   Commit(ShaderToken::Functions, texturize);
+   // Derivatives are passed to the flow function as an argument        
+   const GLSL gradParameter = grad ? ", in vec4 grad" : "";
+   const GLSL gradArgument  = grad ? GLSL {", ", grad} : GLSL {};
+   const GLSL gradLocal     = grad ? "grad" : "";
 
-   //TODO maybe check if uv is required at all?
-   const auto uv = GetTextureCoordinates();
-   if (mKeyframes.GetCount() == 1) {
-      // A single texture channel                                       
-      const GLSL define = "vec4 texturized = Texturize(" + uv + ");\n\n";
-      Commit(ShaderToken::Texturize, define);
-      Expose<Traits::Color, vec4>("texturized");
-      return;
-   }
+   AddDefine(Text {"TextureFlow", sampler}, Text::TemplateRt(
+      TextureFlowFunction, sampler, mKeyframes.GetCount(), times, *symTime,
+      GetPixel(sampler, "vec3(uv, start)", format, gradLocal),
+      GetPixel(sampler, "vec3(uv, end)", format, gradLocal),
+      gradParameter
+   ));
 
-   // Multiple texture channels                                         
-   auto channel = GetSymbol<Traits::Texture>(GetRate(), false);
-   LANGULUS_ASSERT(!channel.IsEmpty(), Material, "No texture channel available")
-   const GLSL define = "vec4 texturized = Texturize(" + channel + ", " + uv + ");\n\n";
-   Commit(ShaderToken::Texturize, define);
-   Expose<Traits::Color, Vec4>("texturized");*/
-   TODO();
-   return NoSymbol;
+   return ExposePixel(
+      Text {"TextureFlow", sampler, "(", uv, gradArgument, ")"}, grad);
 }
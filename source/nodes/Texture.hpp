@@ -7,6 +7,10 @@
 ///                                                                           
 #pragma once
 #include "../Node.hpp"
+#include "../Atlas.hpp"
+#include <Langulus/IO.hpp>
+#include <future>
+#include <list>
 
 
 namespace Nodes
@@ -24,19 +28,55 @@ namespace Nodes
       LANGULUS_BASES(Node);
 
    private:
-      Temporal mKeyframes;
+      // Images, one for each keyframe, bound as layers of a single     
+      // array sampler when there's more than one                       
+      TMany<Ref<A::Image>> mKeyframes;
+      // The time of each keyframe in seconds                           
+      TMany<Real> mTimes;
       Index mTextureId = IndexNone;
-      Ref<A::Image> mTexture;
+      // Whether a small single image is packed in the shared atlas,    
+      // instead of getting a sampler of its own                        
+      bool mAtlas {};
+      // Whether the image was packed, and must be released from the atlas
+      bool mPacked {};
+      // The region the image was packed in                             
+      Atlas::Region mRegion;
+      // Pixel format of each keyframe, if known before its image is    
+      // created, so that generating code doesn't wait for it           
+      TMany<DMeta> mFormats;
+
+      // A keyframe, whose image isn't created yet                      
+      struct Pending {
+         // The keyframe to attach the image to                         
+         Offset mKeyframe;
+         // The image descriptor                                        
+         Construct mDescriptor;
+         // The file reader, and the contents it fills on another thread
+         // Both are allocated here, and left to the worker until done  
+         Ref<A::File::Reader> mReader;
+         TMany<Byte> mContents;
+         ::std::future<void> mRead;
+      };
+      // Pending keyframes are listed, so they don't move while read    
+      ::std::list<Pending> mPending;
+
+      // Bytes read from the start of a file, when probing its format   
+      static constexpr Size ProbeSize = 4096;
 
    public:
       Texture(Describe);
 
       void Detach();
+      bool Attach(bool wait);
       auto Generate() -> const Symbol&;
 
    private:
-      auto CreateTexture(const Many&) -> Ref<A::Image>;
-      auto GenerateKeyframe(const Temporal&) -> GLSL;
+      void CreateTexture(const Many&);
+      void ReadTexture(const Many&);
+      auto GetFormat() -> DMeta;
+      auto GenerateAtlased(DMeta, const GLSL&, const GLSL&) -> const Symbol*;
+      auto ExposePixel(const GLSL&, const GLSL&) -> const Symbol&;
+      auto GenerateFromSymbol(const Symbol&) -> const Symbol&;
    };
 
 } // namespace Nodes
@@ -49,42 +89,61 @@ constexpr Token GetPixelFunction = R"shader(
    texture({0}, {1})
 )shader";
 
-/// Texture flow function                                                     
-///   @param {0} - first keyframe code                                        
-///   @param {1} - intermediate keyframe branches                             
-///   @param {2} - last keyframe code                                         
-constexpr Token TextureFlowFunction = R"shader(
-   vec4 TextureFlow(in float startTime, in float time, in vec2 uv) {{
-      if (time <= startTime) {{
-         // Time before/at start returns first keyframe
-         return {0};
-      }}
-      {1}
-      else {{
-         // Time at/after last keyframe returns last keyframe
-         return {2};
-      }}
-   }}
+/// Get pixel from sampler, with explicit texture coordinate derivatives      
+///   @param {0} - sampler name                                               
+///   @param {1} - texture coordinates                                        
+///   @param {2} - derivatives along horizontal (xy) and vertical (zw) axes   
+constexpr Token GetPixelGradFunction = R"shader(
+   textureGrad({0}, {1}, {2}.xy, {2}.zw)
 )shader";
 
-/// Keyframe without texture transition                                       
-///   @param {0} - frame end time                                             
-///   @param {1} - GetPixelFunction function call                             
-constexpr Token TextureFlowBranch = R"shader(
-   else if (time < {0}) {{
-      return {1};
+/// Fetch from an atlas page - the image's own coordinates wrap around, and   
+/// are mapped into the image's region. Derivatives are taken before the      
+/// coordinates wrap, because wrapping breaks them at the image's edges, and  
+/// they are limited to the mip levels, that the atlas padding covers. The    
+/// overload without derivatives is for pixel stages only                     
+///   @param {0} - unique ID for the function, derived from the region        
+///   @param {1} - sampler name                                               
+///   @param {2} - region scale                                               
+///   @param {3} - region offset                                              
+///   @param {4} - page size in pixels                                        
+///   @param {5} - largest texel footprint, at the last covered mip level     
+constexpr Token AtlasFunction = R"shader(
+   vec4 Atlas{0}(in vec2 uv, in vec4 grad) {{
+      vec2 dx = grad.xy * {2};
+      vec2 dy = grad.zw * {2};
+      float footprint = max(length(dx), length(dy)) * {4};
+      float limit = {5} / max(footprint, {5});
+      return textureGrad({1}, fract(uv) * {2} + {3}, dx * limit, dy * limit);
+   }}
+
+   vec4 Atlas{0}(in vec2 uv) {{
+      return Atlas{0}(uv, vec4(dFdx(uv), dFdy(uv)));
    }}
 )shader";
 
-/// Keyframe with transition                                                  
-///   @param {0} - frame end time                                             
-///   @param {1} - frame start time                                           
-///   @param {2} - frame length (end - start)                                 
-///   @param {3} - GetPixelFunction function call from start side             
-///   @param {4} - GetPixelFunction function call from end side               
-constexpr Token TextureFlowBranchMix = R"shader(
-   else if (time < {0}) {{
-      const float ratio = (time - {1}) / {2};
-      return mix({3}, {4}, ratio);
+/// Texture flow function, that blends the two keyframes around the current   
+/// time, by picking them as layers of an array sampler. The keyframe is      
+/// found by counting passed keyframe times, so there are no branches, and    
+/// the cost is two fetches, regardless of the number of keyframes            
+///   @param {0} - unique ID for the function, derived from the sampler       
+///   @param {1} - number of keyframes                                        
+///   @param {2} - comma-separated keyframe times in seconds                  
+///   @param {3} - time symbol                                                
+///   @param {4} - fetch from the starting keyframe layer                     
+///   @param {5} - fetch from the ending keyframe layer                       
+///   @param {6} - additional texture coordinate derivatives parameter        
+constexpr Token TextureFlowFunction = R"shader(
+   vec4 TextureFlow{0}(in vec2 uv{6}) {{
+      const float times[{1}] = float[{1}]({2});
+      float passed = 0.0;
+      for (int i = 1; i < {1}; i++)
+         passed += step(times[i], {3});
+
+      int start = int(passed);
+      int end = min(start + 1, {1} - 1);
+      float ratio = clamp(({3} - times[start])
+         / max(times[end] - times[start], 1e-6), 0.0, 1.0);
+      return mix({4}, {5}, ratio);
    }}
 )shader";
@@ -0,0 +1,155 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Node.hpp"
+
+
+namespace Nodes
+{
+
+   ///                                                                        
+   ///   Transformation node                                                  
+   ///                                                                        
+   /// Defines the Transform() function, that animates points by keyframes.   
+   /// Keyframes aren't baked into the shader - they are packed in a          
+   /// storage buffer, and evaluated by a single generic function, so that    
+   /// editing an animation is a data update, and not a recompilation.        
+   /// The buffer is registered in the material as instance-rate storage      
+   ///                                                                        
+   struct Transform final : Node {
+      LANGULUS(ABSTRACT) false;
+      LANGULUS_BASES(Node);
+      LANGULUS_CONVERTS_TO(Text);
+
+   private:
+      // Keyframes, packed for the storage buffer, three vectors each:  
+      // position and time, scale and interpolation, orientation        
+      TMany<Vec4f> mKeyframes;
+      // Name of the generated function, unique for each node           
+      Text mFunction;
+
+   public:
+      Transform(Describe&&);
+
+      const Symbol& Generate();
+      auto GetKeyframes() const noexcept -> const TMany<Vec4f>&;
+      auto GetFunction() const noexcept -> const Text&;
+      operator Text() const;
+   };
+
+} // namespace Nodes
+
+
+/// Keyframe structure, shared by all transformation nodes                    
+constexpr Token TransformKeyframeStruct = R"shader(
+   struct TransformKeyframe {
+      vec4 mPosition;   // xyz position, w time in seconds
+      vec4 mScale;      // xyz scale, w interpolation (0 linear, 1 cubic)
+      vec4 mAim;        // orientation quaternion
+   };
+)shader";
+
+/// Keyframe storage buffer, read-only, filled from Transform::GetKeyframes   
+/// Keyframes must be sorted by time                                          
+///   @param {0} - binding index, given by Material::AddStorage, that also    
+///                tells apart the buffers of different nodes                 
+constexpr Token TransformKeyframeBuffer = R"shader(
+   layout(std430, set = 3, binding = {0})
+   readonly buffer TransformKeyframeBuffer{0} {{
+      TransformKeyframe cTransformKeyframes{0}[];
+   }};
+)shader";
+
+/// Cubic interpolation through four points                                   
+constexpr Token TransformCerpFunction = R"shader(
+   vec4 TransformCerp(in vec4 n0, in vec4 n1, in vec4 n2, in vec4 n3, in float a) {
+      const float a2 = a * a;
+      const vec4 p = (n3 - n2) - (n0 - n1);
+      return p * a2 * a + ((n0 - n1) - p) * a2 + (n2 - n0) * a + n1;
+   }
+)shader";
+
+/// Compose a model transformation from position, scale and orientation       
+constexpr Token TransformComposeFunction = R"shader(
+   mat4 TransformCompose(in vec3 position, in vec3 scale, in vec4 orient) {
+      const vec4 o2 = orient * 2.0;
+      const float xx = orient.x * o2.x;
+      const float xy = orient.x * o2.y;
+      const float xz = orient.x * o2.z;
+      const float yy = orient.y * o2.y;
+      const float yz = orient.y * o2.z;
+      const float zz = orient.z * o2.z;
+      const float wx = orient.w * o2.x;
+      const float wy = orient.w * o2.y;
+      const float wz = orient.w * o2.z;
+      return mat4(
+         vec4(1.0 - (yy + zz), xy + wz, xz - wy, 0.0) * scale.x,
+         vec4(xy - wz, 1.0 - (xx + zz), yz + wx, 0.0) * scale.y,
+         vec4(xz + wy, yz - wx, 1.0 - (xx + yy), 0.0) * scale.z,
+         vec4(position, 1.0)
+      );
+   }
+)shader";
+
+/// Evaluate the keyframes at a given time - the keyframe pair is found by    
+/// binary search, so the cost grows only logarithmically with their count    
+///   @param {0} - binding index of the keyframe buffer                       
+constexpr Token TransformAnimateFunction = R"shader(
+   mat4 TransformAnimate{0}(in float time) {{
+      const int count = cTransformKeyframes{0}.length();
+      if (count == 0)
+         return mat4(1.0);
+
+      // Find the last keyframe at or before the time
+      int start = 0;
+      int high = count - 1;
+      while (start < high) {{
+         const int middle = (start + high + 1) / 2;
+         if (cTransformKeyframes{0}[middle].mPosition.w <= time)
+            start = middle;
+         else
+            high = middle - 1;
+      }}
+
+      const int end = min(start + 1, count - 1);
+      const TransformKeyframe a = cTransformKeyframes{0}[start];
+      const TransformKeyframe b = cTransformKeyframes{0}[end];
+      const float ratio = clamp((time - a.mPosition.w)
+         / max(b.mPosition.w - a.mPosition.w, 1e-6), 0.0, 1.0);
+
+      // Interpolate orientations along the shorter arc
+      const vec4 aimB = dot(a.mAim, b.mAim) < 0.0 ? -b.mAim : b.mAim;
+
+      vec4 position, scale, aim;
+      if (a.mScale.w > 0.5) {{
+         const TransformKeyframe p = cTransformKeyframes{0}[max(start - 1, 0)];
+         const TransformKeyframe n = cTransformKeyframes{0}[min(end + 1, count - 1)];
+         position = TransformCerp(p.mPosition, a.mPosition, b.mPosition, n.mPosition, ratio);
+         scale = TransformCerp(p.mScale, a.mScale, b.mScale, n.mScale, ratio);
+         aim = TransformCerp(
+            dot(p.mAim, a.mAim) < 0.0 ? -p.mAim : p.mAim, a.mAim, aimB,
+            dot(n.mAim, aimB) < 0.0 ? -n.mAim : n.mAim, ratio);
+      }}
+      else {{
+         position = mix(a.mPosition, b.mPosition, ratio);
+         scale = mix(a.mScale, b.mScale, ratio);
+         aim = mix(a.mAim, aimB, ratio);
+      }}
+
+      return TransformCompose(position.xyz, scale.xyz, normalize(aim));
+   }}
+)shader";
+
+/// Transform a point by the animation                                        
+///   @param {0} - binding index of the keyframe buffer                       
+///   @param {1} - time symbol                                                
+constexpr Token TransformFunction = R"shader(
+   vec4 Transform{0}(in vec3 point) {{
+      return TransformAnimate{0}({1}) * vec4(point, 1.0);
+   }}
+)shader";
@@ -0,0 +1,142 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Atlas.hpp"
+#include <Langulus/Testing.hpp>
+#include <vector>
+
+
+/// Check if two regions overlap, including the padding around them          
+///   @param a - the first region                                             
+///   @param b - the second region                                            
+///   @param padding - the padding around each region                         
+///   @return true if the padded regions overlap                              
+bool Overlap(const Atlas::Region& a, const Atlas::Region& b, Count padding) {
+   return a.mPage == b.mPage
+      and a.mX < b.mX + b.mWidth  + padding * 2
+      and b.mX < a.mX + a.mWidth  + padding * 2
+      and a.mY < b.mY + b.mHeight + padding * 2
+      and b.mY < a.mY + a.mHeight + padding * 2;
+}
+
+
+SCENARIO("Packing images in an atlas", "[materials]") {
+   GIVEN("An atlas with small pages") {
+      Atlas atlas;
+      atlas.mPageSize = 1024;
+      atlas.mPadding = 4;
+      atlas.mMaxImageSize = 256;
+
+      WHEN("Images of different sizes are checked") {
+         THEN("Only images up to the maximum size are accepted") {
+            REQUIRE(atlas.Accepts(256, 256));
+            REQUIRE(atlas.Accepts(1, 200));
+            REQUIRE_FALSE(atlas.Accepts(257, 16));
+            REQUIRE_FALSE(atlas.Accepts(16, 0));
+         }
+      }
+
+      WHEN("Mip levels are counted") {
+         THEN("Only levels, where the padding is at least a pixel, are used") {
+            REQUIRE(atlas.GetMipCount() == 3);
+            atlas.mPadding = 1;
+            REQUIRE(atlas.GetMipCount() == 1);
+            atlas.mPadding = 16;
+            REQUIRE(atlas.GetMipCount() == 5);
+         }
+      }
+
+      WHEN("A single image is reserved") {
+         const auto region = atlas.Reserve(100, 50);
+
+         THEN("It goes in the bottom-left corner of the first page") {
+            REQUIRE(atlas.GetPageCount() == 1);
+            REQUIRE(region.mPage == 0);
+            REQUIRE(region.mX == 4);
+            REQUIRE(region.mY == 4);
+            REQUIRE(region.mWidth == 100);
+            REQUIRE(region.mHeight == 50);
+         }
+
+         THEN("Its coordinates map into its pixels inside the page") {
+            REQUIRE(region.mScale  == Vec2 {100 / 1024.0, 50 / 1024.0});
+            REQUIRE(region.mOffset == Vec2 {4 / 1024.0, 4 / 1024.0});
+         }
+      }
+
+      WHEN("More images are reserved, than a page can hold") {
+         // Padded images are 108 pixels wide, so 9x9 fit in a page     
+         ::std::vector<Atlas::Region> regions;
+         for (Offset i = 0; i < 82; ++i)
+            regions.push_back(atlas.Reserve(100, 100));
+
+         THEN("Rows are filled bottom to top, and then a new page starts") {
+            REQUIRE(atlas.GetPageCount() == 2);
+            REQUIRE(regions[8].mPage == 0);
+            REQUIRE(regions[8].mX == 8 * 108 + 4);
+            REQUIRE(regions[9].mX == 4);
+            REQUIRE(regions[9].mY == 108 + 4);
+            REQUIRE(regions[80].mPage == 0);
+            REQUIRE(regions[81].mPage == 1);
+            REQUIRE(regions[81].mX == 4);
+            REQUIRE(regions[81].mY == 4);
+         }
+
+         THEN("No two images overlap, and all are inside their page") {
+            for (Offset i = 0; i < regions.size(); ++i) {
+               REQUIRE(regions[i].mX + regions[i].mWidth  + 4 <= 1024);
+               REQUIRE(regions[i].mY + regions[i].mHeight + 4 <= 1024);
+               for (Offset j = i + 1; j < regions.size(); ++j)
+                  REQUIRE_FALSE(Overlap(regions[i], regions[j], 4));
+            }
+         }
+
+         THEN("Resetting releases all pages") {
+            atlas.Reset();
+            REQUIRE(atlas.GetPageCount() == 0);
+         }
+
+         THEN("Freed regions are reused, before starting another page") {
+            atlas.Free(regions[40]);
+            const auto reused = atlas.Reserve(60, 90);
+            REQUIRE(reused.mPage == 0);
+            REQUIRE(reused.mX == regions[40].mX);
+            REQUIRE(reused.mY == regions[40].mY);
+            REQUIRE(reused.mWidth == 60);
+            REQUIRE(reused.mScale == Vec2 {60 / 1024.0, 90 / 1024.0});
+            REQUIRE(atlas.GetPageCount() == 2);
+         }
+
+         THEN("Regions larger than any freed one go elsewhere") {
+            atlas.Free(regions[40]);
+            const auto other = atlas.Reserve(101, 100);
+            REQUIRE(other.mPage == 1);
+         }
+
+         THEN("A page starts over, once all of its regions are freed") {
+            atlas.Free(regions[81]);
+            const auto first = atlas.Reserve(200, 200);
+            REQUIRE(first.mPage == 1);
+            REQUIRE(first.mX == 4);
+            REQUIRE(first.mY == 4);
+         }
+      }
+
+      WHEN("Images of mixed sizes are reserved") {
+         ::std::vector<Atlas::Region> regions;
+         for (Offset i = 0; i < 200; ++i)
+            regions.push_back(atlas.Reserve(16 + (i * 37) % 240, 16 + (i * 53) % 240));
+
+         THEN("No two images overlap") {
+            for (Offset i = 0; i < regions.size(); ++i) {
+               for (Offset j = i + 1; j < regions.size(); ++j)
+                  REQUIRE_FALSE(Overlap(regions[i], regions[j], 4));
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,126 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Baker.hpp"
+#include <Langulus/Math/SimplexNoise.hpp>
+#include <Langulus/Testing.hpp>
+#include <cmath>
+
+
+/// Reference FBM, independent of the baker - the shader's rotation matrix    
+/// mat2(1.6, 1.2, -1.2, 1.6) scales by two and rotates by atan(0.75), so     
+/// octave i samples the point scaled by 2^i and rotated i times at once      
+///   @param u, v - the point to evaluate at                                  
+///   @param octaves - number of octaves                                      
+///   @param weight - weight of the first octave                              
+///   @param scale - the octave expression is SimplexNoise1(uv * scale)       
+///   @param byMass - whether the octave expression is multiplied by mass     
+///   @return the FBM value                                                   
+double ReferenceFBM(double u, double v, Count octaves, double weight, double scale = 1, bool byMass = false) {
+   const double angle = ::std::atan2(0.6, 0.8);
+   double f = 0;
+   for (Offset i = 0; i < octaves; ++i) {
+      const double mass = ::std::pow(weight, i + 1.0);
+      const double s = ::std::pow(2.0, double(i)) * scale;
+      const double c = ::std::cos(angle * i);
+      const double r = ::std::sin(angle * i);
+      const Vec2f point {
+         static_cast<float>(s * (c * u - r * v)),
+         static_cast<float>(s * (r * u + c * v))
+      };
+      const double noise = TSimplex<1, 2, float>::Noise(point);
+      f += mass * (byMass ? noise * mass : noise);
+   }
+   return f;
+}
+
+/// Blend the reference across the four corners, so that it tiles             
+double ReferenceTile(double u, double v, Count octaves, double weight, double scale = 1, bool byMass = false) {
+   return ReferenceFBM(u,     v,     octaves, weight, scale, byMass) * (1 - u) * (1 - v)
+        + ReferenceFBM(u - 1, v,     octaves, weight, scale, byMass) * u       * (1 - v)
+        + ReferenceFBM(u,     v - 1, octaves, weight, scale, byMass) * (1 - u) * v
+        + ReferenceFBM(u - 1, v - 1, octaves, weight, scale, byMass) * u       * v;
+}
+
+
+SCENARIO("Baking noise", "[materials]") {
+   GIVEN("A noise baker") {
+      NoiseBaker baker {16, 3, 0.5};
+
+      WHEN("Mip levels are counted") {
+         THEN("The chain goes down to a single pixel") {
+            REQUIRE(baker.GetMipCount() == 5);
+         }
+      }
+
+      WHEN("Noise is baked") {
+         const auto pixels = baker.Bake();
+
+         THEN("All mip levels are present") {
+            REQUIRE(pixels.GetCount() == 16*16 + 8*8 + 4*4 + 2*2 + 1);
+         }
+
+         THEN("Each texel matches the reference, blended across the corners") {
+            for (Offset y = 0; y < 16; y += 5) {
+               for (Offset x = 0; x < 16; x += 3) {
+                  const double expected = ReferenceTile(x / 16.0, y / 16.0, 3, 0.5);
+                  REQUIRE(::std::abs(pixels[y * 16 + x] - expected) < 1e-4);
+               }
+            }
+         }
+
+         THEN("Each mip level averages the previous one") {
+            const auto* level0 = pixels.GetRaw();
+            const auto* level1 = level0 + 16 * 16;
+            for (Offset y = 0; y < 8; ++y) {
+               for (Offset x = 0; x < 8; ++x) {
+                  const float average = (
+                       level0[(y * 2)     * 16 + x * 2]
+                     + level0[(y * 2)     * 16 + x * 2 + 1]
+                     + level0[(y * 2 + 1) * 16 + x * 2]
+                     + level0[(y * 2 + 1) * 16 + x * 2 + 1]
+                  ) * 0.25f;
+                  REQUIRE(::std::abs(level1[y * 8 + x] - average) < 1e-6f);
+               }
+            }
+         }
+      }
+
+      WHEN("Noise is baked from an octave, that reads the mass") {
+         baker.mOctave = "(SimplexNoise1((uv * 2.0)) * mass)";
+         const auto pixels = baker.Bake();
+
+         THEN("Each texel matches the reference") {
+            for (Offset y = 0; y < 16; y += 5) {
+               for (Offset x = 0; x < 16; x += 3) {
+                  const double expected = ReferenceTile(x / 16.0, y / 16.0, 3, 0.5, 2, true);
+                  REQUIRE(::std::abs(pixels[y * 16 + x] - expected) < 1e-4);
+               }
+            }
+         }
+      }
+   }
+
+   GIVEN("Octave expressions") {
+      THEN("Expressions of the octave parameters can be baked") {
+         REQUIRE(NoiseBaker::IsBakeable("SimplexNoise1(uv)"));
+         REQUIRE(NoiseBaker::IsBakeable("(SimplexNoise1(vec3(uv, float(octave))) * mass)"));
+         REQUIRE(NoiseBaker::IsBakeable("abs(SimplexNoise1((uv.yx * 4.0)) - 0.5)"));
+      }
+
+      THEN("Expressions of any other input can't be baked") {
+         REQUIRE_FALSE(NoiseBaker::IsBakeable("SimplexNoise1((uv + PerTick.Time))"));
+         REQUIRE_FALSE(NoiseBaker::IsBakeable("SimplexNoise1(vec3(uv, inTime))"));
+         REQUIRE_FALSE(NoiseBaker::IsBakeable("Hash(uv)"));
+      }
+
+      THEN("Expressions, that don't result in a scalar, can't be baked") {
+         REQUIRE_FALSE(NoiseBaker::IsBakeable("uv"));
+         REQUIRE_FALSE(NoiseBaker::IsBakeable("SimplexNoise1(uv.x)"));
+      }
+   }
+}
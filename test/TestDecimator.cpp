@@ -0,0 +1,159 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Decimator.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+
+
+/// Texture coordinates of a grid point                                       
+/// Quads right of the seam are mapped to another part of the texture, so     
+/// points on the seam have different coordinates on each side                
+///   @param p - the point                                                    
+///   @param size - number of quads on each side                              
+///   @param right - whether the point is used by a quad right of the seam    
+///   @return the texture coordinates                                         
+Vec2 GridUV(const Vec3& p, Count size, bool right) {
+   return {p[0] / size + (right ? Real {0.5} : Real {0}), p[1] / size};
+}
+
+/// Make a square grid of triangles over the XY plane                         
+///   @param size - number of quads on each side                              
+///   @param bend - how much the grid is bent into a bowl, zero for flat      
+///   @param seam - column of the texture seam, zero for no seam              
+///   @return the triangles, two per quad                                     
+Decimator::Triangles MakeGrid(Count size, Real bend = 0, Offset seam = 0) {
+   Decimator::Triangles grid;
+   const auto point = [&](Offset x, Offset y) {
+      const Real dx = Real(x) - Real(size) / 2;
+      const Real dy = Real(y) - Real(size) / 2;
+      return Vec3 {Real(x), Real(y), bend * (dx * dx + dy * dy)};
+   };
+
+   const auto triangle = [&](const Vec3& a, const Vec3& b, const Vec3& c, bool right) {
+      const auto n = (b - a).Cross(c - a);
+      return Decimator::Triangle {
+         a, GridUV(a, size, right),
+         b, GridUV(b, size, right),
+         c, GridUV(c, size, right),
+         n / n.Length()
+      };
+   };
+
+   for (Offset y = 0; y < size; ++y) {
+      for (Offset x = 0; x < size; ++x) {
+         const bool right = seam and x >= seam;
+         const auto p00 = point(x,     y);
+         const auto p10 = point(x + 1, y);
+         const auto p11 = point(x + 1, y + 1);
+         const auto p01 = point(x,     y + 1);
+         grid << triangle(p00, p10, p11, right);
+         grid << triangle(p00, p11, p01, right);
+      }
+   }
+   return grid;
+}
+
+/// Sum the areas of the triangles, whose centroids are inside a rectangle    
+///   @param triangles - the triangles to measure                             
+///   @param min - the rectangle's lower corner                               
+///   @param max - the rectangle's upper corner                               
+///   @return the total area                                                  
+Real AreaInside(const Decimator::Triangles& triangles, const Vec2& min, const Vec2& max) {
+   Real area = 0;
+   for (auto& t : triangles) {
+      const Vec3 c = (t.a + t.b + t.c) / Real {3};
+      if (c[0] < min[0] or c[0] > max[0] or c[1] < min[1] or c[1] > max[1])
+         continue;
+      area += (t.b - t.a).Cross(t.c - t.a).Length() / 2;
+   }
+   return area;
+}
+
+
+SCENARIO("Triangle decimation", "[materials]") {
+   GIVEN("A flat 32x32 grid of 2048 triangles") {
+      const auto grid = MakeGrid(32);
+      REQUIRE(grid.GetCount() == 2048);
+
+      WHEN("Simplified without a budget or an error threshold") {
+         Decimator decimator;
+         const auto result = decimator.Simplify(grid);
+
+         THEN("Triangles are returned unchanged") {
+            REQUIRE_FALSE(decimator.IsEnabled());
+            REQUIRE(result.GetCount() == grid.GetCount());
+         }
+      }
+
+      WHEN("Simplified to a budget, in four clusters of 512 triangles") {
+         Decimator decimator;
+         decimator.mBudget = 512;
+         decimator.mClusterSize = 256;
+         const auto result = decimator.Simplify(grid);
+
+         THEN("Triangle count is reduced") {
+            REQUIRE(decimator.IsEnabled());
+            REQUIRE(result.GetCount() > 0);
+            REQUIRE(result.GetCount() <= grid.GetCount() / 2);
+         }
+
+         THEN("Each cluster still covers its quarter of the grid") {
+            // Cluster borders are locked, so no triangle may cross     
+            // them, and no holes may appear inside them                
+            for (Offset y = 0; y < 2; ++y) {
+               for (Offset x = 0; x < 2; ++x) {
+                  const Vec2 min {Real(x * 16), Real(y * 16)};
+                  const Vec2 max {Real(x * 16 + 16), Real(y * 16 + 16)};
+                  REQUIRE(::std::abs(AreaInside(result, min, max) - 256) < 1e-3);
+               }
+            }
+         }
+      }
+   }
+}
+
+SCENARIO("Triangle decimation of curved and textured surfaces", "[materials]") {
+   GIVEN("A 32x32 grid, bent into a bowl") {
+      const auto grid = MakeGrid(32, Real {0.05});
+
+      WHEN("Simplified to a budget") {
+         Decimator decimator;
+         decimator.mBudget = 256;
+         const auto result = decimator.Simplify(grid);
+
+         THEN("Normals match the simplified faces, and not the welded ones") {
+            REQUIRE(result.GetCount() < grid.GetCount());
+            for (auto& t : result) {
+               auto n = (t.b - t.a).Cross(t.c - t.a);
+               n /= n.Length();
+               REQUIRE(::std::abs(t.n.Dot(n) - 1) < 1e-3);
+            }
+         }
+      }
+   }
+
+   GIVEN("A flat 32x32 grid with a texture seam in the middle") {
+      const auto grid = MakeGrid(32, 0, 16);
+
+      WHEN("Simplified to a budget") {
+         Decimator decimator;
+         decimator.mBudget = 256;
+         const auto result = decimator.Simplify(grid);
+
+         THEN("Texture coordinates still follow the positions on both sides") {
+            REQUIRE(result.GetCount() < grid.GetCount());
+            for (auto& t : result) {
+               const bool right = (t.a[0] + t.b[0] + t.c[0]) / 3 > 16;
+               REQUIRE((t.aUV - GridUV(t.a, 32, right)).Length() < 1e-4);
+               REQUIRE((t.bUV - GridUV(t.b, 32, right)).Length() < 1e-4);
+               REQUIRE((t.cUV - GridUV(t.c, 32, right)).Length() < 1e-4);
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,88 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/ImageFile.hpp"
+#include <Langulus/Testing.hpp>
+#include <vector>
+
+
+/// Make the start of a PNG file - a signature, an IHDR chunk, the given      
+/// chunks, and the start of the image data                                   
+///   @param depth - bits per channel                                         
+///   @param color - PNG color type                                           
+///   @param chunks - the types of the chunks between IHDR and IDAT           
+///   @return the file contents                                               
+auto MakePNG(uint8_t depth, uint8_t color, ::std::vector<Token> chunks = {}) -> ::std::vector<Byte> {
+   ::std::vector<uint8_t> file {
+      137, 'P', 'N', 'G', '\r', '\n', 26, '\n',
+      0, 0, 0, 13, 'I', 'H', 'D', 'R',
+      0, 0, 1, 0,    // Width
+      0, 0, 0, 64,   // Height
+      depth, color, 0, 0, 0,
+      0, 0, 0, 0     // CRC
+   };
+
+   // Each chunk carries three bytes of data                            
+   chunks.push_back("IDAT");
+   for (auto type : chunks) {
+      file.insert(file.end(), {0, 0, 0, 3});
+      file.insert(file.end(), type.begin(), type.end());
+      file.insert(file.end(), {1, 2, 3, 0, 0, 0, 0});
+   }
+
+   ::std::vector<Byte> result(file.size());
+   for (Offset i = 0; i < file.size(); ++i)
+      result[i] = static_cast<Byte>(file[i]);
+   return result;
+}
+
+/// Probe the format of file contents                                         
+DMeta Probe(const ::std::vector<Byte>& file) {
+   return ProbeImageFormat(file.data(), file.size());
+}
+
+
+SCENARIO("Probing image files", "[materials]") {
+   GIVEN("PNG files with different pixel formats") {
+      THEN("The format is read from the header") {
+         REQUIRE(Probe(MakePNG(8,  2)) == MetaOf<TVector<uint8_t, 3>>());
+         REQUIRE(Probe(MakePNG(8,  6)) == MetaOf<TVector<uint8_t, 4>>());
+         REQUIRE(Probe(MakePNG(16, 0)) == MetaOf<TVector<uint16_t, 1>>());
+         REQUIRE(Probe(MakePNG(8,  4)) == MetaOf<TVector<uint8_t, 2>>());
+      }
+
+      THEN("Palettes are expanded to 8-bit colors") {
+         REQUIRE(Probe(MakePNG(4, 3, {"PLTE"})) == MetaOf<TVector<uint8_t, 3>>());
+      }
+
+      THEN("Transparency is expanded to an alpha channel") {
+         REQUIRE(Probe(MakePNG(8,  3, {"PLTE", "tRNS"})) == MetaOf<TVector<uint8_t, 4>>());
+         REQUIRE(Probe(MakePNG(8,  2, {"tRNS"}))         == MetaOf<TVector<uint8_t, 4>>());
+         REQUIRE(Probe(MakePNG(16, 0, {"gAMA", "tRNS"})) == MetaOf<TVector<uint16_t, 2>>());
+      }
+   }
+
+   GIVEN("Contents, that aren't recognized") {
+      const Token text = "Not a PNG file, just some text, long enough for a header";
+      ::std::vector<Byte> textFile(text.size());
+      for (Offset i = 0; i < text.size(); ++i)
+         textFile[i] = static_cast<Byte>(text[i]);
+
+      auto truncated = MakePNG(8, 3, {"PLTE", "tRNS"});
+      truncated.resize(40);
+
+      THEN("No format is probed") {
+         REQUIRE_FALSE(Probe(textFile));
+         REQUIRE_FALSE(Probe(MakePNG(8, 5)));
+         REQUIRE_FALSE(Probe({}));
+      }
+
+      THEN("No format is probed, if transparency might follow") {
+         REQUIRE_FALSE(Probe(truncated));
+      }
+   }
+}
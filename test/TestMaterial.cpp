@@ -43,6 +43,33 @@ constexpr auto MaterialCode = R"code(
 )code";
 
 
+/// Create a material from code, and generate all of its shader stages        
+///   @param root - the entity to create the material in                      
+///   @param code - the material code                                         
+///   @return the code of all stages, concatenated                            
+Text GenerateShaders(Thing& root, const Code& code) {
+   auto producedMaterial = root.CreateUnit<A::Material>(code);
+   root.Update({});
+   REQUIRE(producedMaterial.GetCount() == 1);
+
+   auto material = producedMaterial.As<A::Material*>();
+   REQUIRE(material->Generate(MetaOf<Traits::Shader>()));
+
+   Text result;
+   for (auto& stage : *material->GetDataList<Traits::Shader>())
+      result += stage.As<Text>();
+   return result;
+}
+
+/// Check if generated code contains a snippet                                
+///   @param code - the generated code                                        
+///   @param what - the snippet to search for                                 
+///   @return true if the snippet was found                                   
+bool Contains(const Text& code, const Token& what) {
+   return Token {code}.find(what) != Token::npos;
+}
+
+
 SCENARIO("Shader generation", "[materials]") {
    static Allocator::State memoryState;
 
@@ -89,3 +116,103 @@ SCENARIO("Shader generation", "[materials]") {
    }
 }
 
+SCENARIO("Domain repetition", "[materials]") {
+   static Allocator::State memoryState;
+
+   GIVEN("A repeated box, with per-cell variation") {
+      auto root = Thing::Root<false>("AssetsMaterials");
+
+      WHEN("The scene is raymarched") {
+         const auto code = GenerateShaders(root, Code(R"code(
+            Nodes::Scene(
+               A::Mesh(Box3(1, 1, 1), Repeat(4, 4, 0), Count(3, 3, 1), Variation(1, 0.5, 0))
+            ),
+            Nodes::Raymarch
+         )code"));
+
+         THEN("A single cell is evaluated in a folded space") {
+            REQUIRE(Contains(code, "float SDFRepeat0(in vec3 point)"));
+            REQUIRE(Contains(code, "clamp(round(point * vec3("));
+            REQUIRE(Contains(code, "SDFHash3(cell)"));
+            REQUIRE(Contains(code, "SDFBox3("));
+         }
+      }
+
+      REQUIRE(memoryState.Assert());
+   }
+}
+
+SCENARIO("Transform keyframes", "[materials]") {
+   static Allocator::State memoryState;
+
+   GIVEN("Two animated transformations") {
+      auto root = Thing::Root<false>("AssetsMaterials");
+
+      WHEN("Their shaders are generated") {
+         const auto code = GenerateShaders(root, Code(R"code(
+            Nodes::Transform(Time(0, 2), Place(Vec3(7, 8, 9), Vec3(7, 8, 10))),
+            Nodes::Transform(Strategy(`Cubic`), Time(0, 1, 3), Scale(Vec3(2), Vec3(4), Vec3(6)))
+         )code"));
+
+         THEN("Each node gets its own keyframe buffer and functions") {
+            REQUIRE(Contains(code, "struct TransformKeyframe {"));
+            REQUIRE(Contains(code, "layout(std430, set = 3, binding = 0)"));
+            REQUIRE(Contains(code, "layout(std430, set = 3, binding = 1)"));
+            REQUIRE(Contains(code, "TransformKeyframe cTransformKeyframes0[];"));
+            REQUIRE(Contains(code, "TransformKeyframe cTransformKeyframes1[];"));
+            REQUIRE(Contains(code, "mat4 TransformAnimate0(in float time)"));
+            REQUIRE(Contains(code, "mat4 TransformAnimate1(in float time)"));
+            REQUIRE(Contains(code, "vec4 Transform0(in vec3 point)"));
+            REQUIRE(Contains(code, "vec4 Transform1(in vec3 point)"));
+         }
+
+         THEN("No keyframe data is baked into the shader code") {
+            REQUIRE_FALSE(Contains(code, "cKeyframe"));
+            REQUIRE_FALSE(Contains(code, "vec3(7"));
+            REQUIRE_FALSE(Contains(code, "vec4(7"));
+         }
+      }
+
+      REQUIRE(memoryState.Assert());
+   }
+}
+
+SCENARIO("Rasterizing transformed scenes", "[materials]") {
+   static Allocator::State memoryState;
+
+   GIVEN("A rasterizer") {
+      auto root = Thing::Root<false>("AssetsGeometry", "AssetsMaterials");
+
+      WHEN("It has an animated Transform node") {
+         const auto code = GenerateShaders(root, Code(R"code(
+            Nodes::Raster({
+               Nodes::Transform(Time(0, 2), Place(Vec3(7, 8, 9), Vec3(7, 8, 10))),
+               Nodes::Scene(A::Mesh(Box3(1, 1, 1)))
+            })
+         )code"));
+
+         THEN("Points are transformed by the node's function") {
+            REQUIRE(Contains(code, "vec4 Transform0(in vec3 point)"));
+            REQUIRE(Contains(code, "vec4 pt0 = mvp * Transform0(triangle.a);"));
+            REQUIRE(Contains(code, "vec4 pt2 = mvp * Transform0(triangle.c);"));
+            REQUIRE_FALSE(Contains(code, "vec4 Transform(in vec3 point)"));
+         }
+      }
+
+      WHEN("It has no Transform node") {
+         const auto code = GenerateShaders(root, Code(R"code(
+            Nodes::Raster({
+               Nodes::Scene(A::Mesh(Box3(1, 1, 1)))
+            })
+         )code"));
+
+         THEN("Points are transformed by the identity function") {
+            REQUIRE(Contains(code, "vec4 Transform(in vec3 point)"));
+            REQUIRE(Contains(code, "return vec4(point, 1.0);"));
+            REQUIRE(Contains(code, "vec4 pt0 = mvp * Transform(triangle.a);"));
+         }
+      }
+
+      REQUIRE(memoryState.Assert());
+   }
+}
@@ -0,0 +1,74 @@
+///                                                                           
+/// Langulus::Module::Assets::Materials                                       
+/// Copyright (c) 2016 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Packing.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+
+
+/// Decode an octahedral normal, the same way DecodeTriangleFunction does     
+///   @param packed - two 16-bit snorms, as produced by packSnorm2x16         
+///   @return the decoded unit normal                                         
+Vec3 DecodeOctahedral(uint32_t packed) {
+   const auto snorm = [](uint32_t bits) {
+      const auto fixed = static_cast<int16_t>(bits & 0xFFFFu);
+      return ::std::max(Real(fixed) / Real {32767}, Real {-1});
+   };
+
+   Vec3 n {snorm(packed), snorm(packed >> 16), 0};
+   n[2] = Real {1} - ::std::abs(n[0]) - ::std::abs(n[1]);
+   const auto t = ::std::max(-n[2], Real {0});
+   n[0] += n[0] >= 0 ? -t : t;
+   n[1] += n[1] >= 0 ? -t : t;
+   return n / n.Length();
+}
+
+
+SCENARIO("Triangle quantization", "[materials]") {
+   GIVEN("Numbers in the [0; 1] range") {
+      THEN("They are quantized to the full 16-bit range") {
+         REQUIRE(PackUnorm16(0)   == 0);
+         REQUIRE(PackUnorm16(1)   == 65535);
+         REQUIRE(PackUnorm16(0.5) == 32768);
+      }
+
+      THEN("Numbers outside the range are clamped") {
+         REQUIRE(PackUnorm16(-1) == 0);
+         REQUIRE(PackUnorm16(2)  == 65535);
+      }
+   }
+
+   GIVEN("Texture coordinates") {
+      THEN("Half floats match the IEEE 754 binary16 encoding") {
+         REQUIRE(PackHalf(0)      == 0x0000u);
+         REQUIRE(PackHalf(1)      == 0x3C00u);
+         REQUIRE(PackHalf(0.5)    == 0x3800u);
+         REQUIRE(PackHalf(-2)     == 0xC000u);
+         REQUIRE(PackHalf(65504)  == 0x7BFFu);
+         REQUIRE(PackHalf(1e6)    == 0x7C00u);
+         REQUIRE(PackHalf(0x1p-24) == 0x0001u);
+      }
+   }
+
+   GIVEN("Unit normals in all octants") {
+      const Vec3 normals[] {
+         { 1,  0,  0}, {-1,  0,  0},
+         { 0,  1,  0}, { 0, -1,  0},
+         { 0,  0,  1}, { 0,  0, -1},
+         { 1,  2,  3}, {-1,  2, -3},
+         { 3, -2,  1}, {-3, -2, -1}
+      };
+
+      THEN("They survive the octahedral encoding") {
+         for (auto normal : normals) {
+            normal /= normal.Length();
+            const auto decoded = DecodeOctahedral(PackOctahedral(normal));
+            REQUIRE((decoded - normal).Length() < 1e-3);
+         }
+      }
+   }
+}